@@ -19,6 +19,7 @@
 #import <ComponentKit/CKOptional.h>
 #import <ComponentKit/CKTreeNode.h>
 #import <ComponentKit/CKSystraceListener.h>
+#import <ComponentKit/CKUpdateMode.h>
 
 @protocol CKMountable;
 
@@ -32,6 +33,15 @@ struct ComponentTreeDiff;
 
 /**
  This protocol is being used by the infrastructure to collect data about the component tree life cycle.
+
+ @discussion The callbacks are not all called on the thread that builds or lays out the component tree:
+ - With CKGlobalConfig.buildRenderChildrenConcurrently, the sibling render components of a tree are built on worker
+   threads, so `didReuseNode:inScopeRoot:fromPreviousScopeRoot:` is called from these threads, concurrently and in no
+   particular order. Concurrent builds are skipped while `systraceListener` returns a listener or
+   `shouldCollectTreeNodeCreationInformation:` returns YES, so build systrace events and
+   `didBuildTreeNodeForPrecomputedChild` stay on the building thread.
+ - With CKFlexboxComponentStyle.measureChildrenConcurrently, the layout systrace events of the children of a flexbox are
+   sent from worker threads, each nested on its own thread.
  */
 @protocol CKAnalyticsListener <NSObject>
 
@@ -90,6 +100,16 @@ struct ComponentTreeDiff;
 */
 - (void)didLayoutComponentTreeWithRootComponent:(id<CKMountable>)component;
 
+/**
+ Called after the post-layout processing of a component tree, which is part of `CKComputeRootComponentLayout`: building
+ the layout lookup for components with controllers, collecting components matching the animation predicates and the
+ tree verifications.
+
+ @param component The root component that was laid out.
+ @param duration Time spent in the post-layout processing, in seconds.
+ */
+- (void)didProcessLayoutOfComponentTreeWithRootComponent:(id<CKMountable>)component duration:(CFTimeInterval)duration;
+
 /**
  Called before/after mounting a component tree
 
@@ -128,6 +148,7 @@ inComponentTreeWithRootComponent:(id<CKMountable>)component
  @param scopeRoot Scope root for component tree.
  @param previousScopeRoot The previous scope root of the component tree
  @warning A node is only reused if conforming to the render protocol.
+ @discussion Can be called from several threads at once when sibling render components are built concurrently.
  */
 - (void)didReuseNode:(CKTreeNode *)node
          inScopeRoot:(CKComponentScopeRoot *)scopeRoot
@@ -135,6 +156,9 @@ fromPreviousScopeRoot:(CKComponentScopeRoot *)previousScopeRoot;
 
 /**
  Provides a systrace listener. Can be nil if systrace is not enabled.
+
+ @discussion Sibling render components are not built concurrently while this returns a listener, but the layout events
+ of children that flexbox components measure concurrently are still sent from worker threads.
  */
 - (id<CKSystraceListener>)systraceListener;
 
@@ -155,6 +179,18 @@ fromPreviousScopeRoot:(CKComponentScopeRoot *)previousScopeRoot;
 - (void)didReceiveStateUpdateFromScopeHandle:(CKComponentScopeHandle *)handle
                               rootIdentifier:(CKComponentScopeRootIdentifier)rootID;
 
+/**
+ Called when the state updates received before a display refresh are delivered as a single update, see
+ `CKComponentGeneratorOptions.coalescesStateUpdatesUntilNextFrame`.
+
+ @param stateUpdateCount The number of state updates in the batch.
+ @param mode The strictest update mode in the batch, which the batch is delivered with.
+ @param rootID The identifier of the scope root the state updates are for.
+ */
+- (void)didCoalesceStateUpdates:(NSUInteger)stateUpdateCount
+                       withMode:(CKUpdateMode)mode
+                 rootIdentifier:(CKComponentScopeRootIdentifier)rootID;
+
 @end
 
 #endif
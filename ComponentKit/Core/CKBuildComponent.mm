@@ -17,6 +17,7 @@
 #import "CKComponentInternal.h"
 #import "CKComponentScopeRoot.h"
 #import "CKComponentSubclass.h"
+#import "CKGenerationToken.h"
 #import "CKRenderHelpers.h"
 #import "CKThreadLocalComponentScope.h"
 #import "CKTreeNode.h"
@@ -129,8 +130,11 @@ CKBuildComponentResult CKBuildComponent(CK::NonNull<CKComponentScopeRoot *> prev
 #endif
   auto const component = componentFactory();
 
+  // A superseded generation is thrown away; don't build its tree.
+  auto const isCancelled = CKGenerationToken::isCurrentCancelled();
+
   // Build the component tree if we have a render component in the hierarchy.
-  if ([threadScope.newScopeRoot hasRenderComponentInTree] || globalConfig.alwaysBuildRenderTree) {
+  if (!isCancelled && ([threadScope.newScopeRoot hasRenderComponentInTree] || globalConfig.alwaysBuildRenderTree)) {
     CKBuildComponentTreeParams params = {
       .scopeRoot = threadScope.newScopeRoot,
       .previousScopeRoot = previousRoot,
@@ -140,6 +144,7 @@ CKBuildComponentResult CKBuildComponent(CK::NonNull<CKComponentScopeRoot *> prev
       .systraceListener = threadScope.systraceListener,
       .shouldCollectTreeNodeCreationInformation = shouldCollectTreeNodeCreationInformation,
       .coalescingMode = coalescingMode,
+      .buildsChildrenConcurrently = globalConfig.buildRenderChildrenConcurrently,
     };
 
     // Build the component tree from the render function.
@@ -147,7 +152,9 @@ CKBuildComponentResult CKBuildComponent(CK::NonNull<CKComponentScopeRoot *> prev
   }
 
   auto newScopeRoot = threadScope.newScopeRoot;
-  auto const boundsAnimation = CKBuildComponentHelpers::boundsAnimationFromPreviousScopeRoot(newScopeRoot, previousRoot);
+  auto const boundsAnimation = isCancelled
+  ? CKComponentBoundsAnimation {}
+  : CKBuildComponentHelpers::boundsAnimationFromPreviousScopeRoot(newScopeRoot, previousRoot);
 
   [analyticsListener didBuildComponentTreeWithScopeRoot:newScopeRoot
                                            buildTrigger:buildTrigger
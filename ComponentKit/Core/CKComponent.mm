@@ -48,6 +48,8 @@
 #import "CKComponentCreationValidation.h"
 #import "CKSizeAssert.h"
 
+#import <RenderCoreLayoutCaching/RCLayoutMemo.h>
+
 CGFloat const kCKComponentParentDimensionUndefined = NAN;
 CGSize const kCKComponentParentSizeUndefined = {kCKComponentParentDimensionUndefined, kCKComponentParentDimensionUndefined};
 
@@ -337,6 +339,14 @@ void CKComponentWillLayout(CKComponent *component, CKSizeRange constrainedSize,
   [systraceListener willLayoutComponent:component];
 }
 
+static RCLayout computeLayoutRestrictedToSize(id<CKMountable> mountable, const CKSizeRange &constrainedSize, CGSize parentSize)
+{
+  const auto component = (CKComponent *)mountable;
+  return [component computeLayoutThatFits:constrainedSize
+                         restrictedToSize:component->_size
+                     relativeToParentSize:parentSize];
+}
+
 - (RCLayout)layoutThatFits:(CKSizeRange)constrainedSize parentSize:(CGSize)parentSize
 {
 #if CK_ASSERTIONS_ENABLED
@@ -347,9 +357,11 @@ void CKComponentWillLayout(CKComponent *component, CKSizeRange constrainedSize,
   auto const systraceListener = context.systraceListener;
   CKComponentWillLayout(self, constrainedSize, parentSize, systraceListener);
   
-  RCLayout layout = [self computeLayoutThatFits:constrainedSize
-                               restrictedToSize:_size
-                           relativeToParentSize:parentSize];
+  RCLayout layout = [[self class] hasLayoutContentKey]
+  ? RCFetchOrComputeMemoizedLayout(self, [self layoutContentKey], constrainedSize, parentSize, &computeLayoutRestrictedToSize)
+  : [self computeLayoutThatFits:constrainedSize
+               restrictedToSize:_size
+           relativeToParentSize:parentSize];
   
   CKComponentDidLayout(self, layout, constrainedSize, parentSize, systraceListener);
   
@@ -438,6 +450,26 @@ static void *kRootComponentMountedViewKey = &kRootComponentMountedViewKey;
   return RCComponentCoalescingModeNone;
 }
 
++ (BOOL)hasMonotonicSizing
+{
+  return NO;
+}
+
+- (BOOL)sizeIsRelativeToParentSize
+{
+  return _size.isRelativeToParentSize();
+}
+
++ (BOOL)hasLayoutContentKey
+{
+  return NO;
+}
+
+- (id<NSObject>)layoutContentKey
+{
+  return nil;
+}
+
 + (Class<CKComponentControllerProtocol>)controllerClass
 {
   const Class componentClass = self;
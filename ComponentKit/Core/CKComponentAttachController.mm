@@ -14,6 +14,7 @@
 #import <ComponentKit/CKAnalyticsListener.h>
 #import <ComponentKit/RCAssociatedObject.h>
 #import <ComponentKit/CKDelayedNonNull.h>
+#import <ComponentKit/CKGlobalConfig.h>
 #import <ComponentKit/CKOptional.h>
 
 #import "CKComponentAnimations.h"
@@ -165,11 +166,15 @@ static CKComponentAttachState *mountComponentLayoutInView(const CKComponentRootL
 
   auto const oldAttachState = CKGetAttachStateForView(view);
   NSSet *currentlyMountedComponents = oldAttachState.mountedComponents;
+  auto incrementalMountState = oldAttachState != nil ? oldAttachState.incrementalMountState : nullptr;
+  if (!incrementalMountState && CKReadGlobalConfig().enableIncrementalMount) {
+    incrementalMountState = std::make_shared<RCIncrementalMountState>();
+  }
   __block NSSet *newMountedComponents = nil;
   const auto mountPerformer = ^{
     __block NSMutableSet<CKComponent *> *unmountedComponents;
     CKComponentBoundsAnimationApply(boundsAnimation, ^{
-      newMountedComponents = CKMountComponentLayout(rootLayout.layout(), view, currentlyMountedComponents, nil, analyticsListener);
+      newMountedComponents = CKMountComponentLayout(rootLayout.layout(), view, currentlyMountedComponents, nil, analyticsListener, incrementalMountState.get());
 
       // This could probably be done more efficiently by making mountPerformer
       // return a pair: currentlyMountedComponents & newMountedComponents.
@@ -186,7 +191,8 @@ static CKComponentAttachState *mountComponentLayoutInView(const CKComponentRootL
 
   const auto attachState = [[CKComponentAttachState alloc] initWithScopeIdentifier:scopeIdentifier
                                                                  mountedComponents:CK::makeNonNull(newMountedComponents)
-                                                               animationApplicator:animationApplicator];
+                                                               animationApplicator:animationApplicator
+                                                             incrementalMountState:incrementalMountState];
   CKComponentAttachStateSetRootLayout(attachState, rootLayout);
   return attachState;
 }
@@ -210,18 +216,31 @@ static void tearDownAttachStateFromViews(NSArray<UIView *> *views)
   CKComponentRootLayout _rootLayout;
   // The ownership isn't really shared with anyone, this is just to get copying the pointer in and out of the attach state easier
   std::shared_ptr<CK::AnimationApplicator<>> _animationApplicator;
+  std::shared_ptr<RCIncrementalMountState> _incrementalMountState;
   CK::DelayedNonNull<NSSet *> _mountedComponents;
 }
 
 - (instancetype)initWithScopeIdentifier:(CKComponentScopeRootIdentifier)scopeIdentifier
                       mountedComponents:(CK::NonNull<NSSet *>)mountedComponents
                     animationApplicator:(const std::shared_ptr<CK::AnimationApplicator<>> &)animationApplicator
+{
+  return [self initWithScopeIdentifier:scopeIdentifier
+                     mountedComponents:mountedComponents
+                   animationApplicator:animationApplicator
+                 incrementalMountState:nullptr];
+}
+
+- (instancetype)initWithScopeIdentifier:(CKComponentScopeRootIdentifier)scopeIdentifier
+                      mountedComponents:(CK::NonNull<NSSet *>)mountedComponents
+                    animationApplicator:(const std::shared_ptr<CK::AnimationApplicator<>> &)animationApplicator
+                  incrementalMountState:(const std::shared_ptr<RCIncrementalMountState> &)incrementalMountState
 {
   self = [super init];
   if (self) {
     _scopeIdentifier = scopeIdentifier;
     _mountedComponents = CK::makeNonNull([mountedComponents copy]);
     _animationApplicator = animationApplicator;
+    _incrementalMountState = incrementalMountState;
   }
   return self;
 }
@@ -241,6 +260,11 @@ void CKComponentAttachStateSetRootLayout(CKComponentAttachState *const self, con
   return _animationApplicator;
 }
 
+- (const std::shared_ptr<RCIncrementalMountState> &)incrementalMountState
+{
+  return _incrementalMountState;
+}
+
 - (CK::NonNull<NSSet *>)mountedComponents
 {
   return _mountedComponents;
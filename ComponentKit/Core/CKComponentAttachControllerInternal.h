@@ -18,6 +18,7 @@
 #import <ComponentKit/CKComponentAttachController.h>
 #import <ComponentKit/CKComponentScopeTypes.h>
 #import <ComponentKit/CKNonNull.h>
+#import <ComponentKit/RCLayout.h>
 
 @protocol CKComponentRootLayoutProvider;
 
@@ -31,7 +32,13 @@
                       mountedComponents:(CK::NonNull<NSSet *>)mountedComponents
                     animationApplicator:(const std::shared_ptr<CK::AnimationApplicator<>> &)animationApplicator;
 
+- (instancetype)initWithScopeIdentifier:(CKComponentScopeRootIdentifier)scopeIdentifier
+                      mountedComponents:(CK::NonNull<NSSet *>)mountedComponents
+                    animationApplicator:(const std::shared_ptr<CK::AnimationApplicator<>> &)animationApplicator
+                  incrementalMountState:(const std::shared_ptr<RCIncrementalMountState> &)incrementalMountState;
+
 - (const std::shared_ptr<CK::AnimationApplicator<>> &)animationApplicator;
+- (const std::shared_ptr<RCIncrementalMountState> &)incrementalMountState;
 
 @end
 
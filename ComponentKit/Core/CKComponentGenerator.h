@@ -18,6 +18,7 @@
 #import <unordered_set>
 
 #import <ComponentKit/CKBuildComponentResult.h>
+#import <ComponentKit/CKComponentLayout.h>
 #import <ComponentKit/CKComponentProvider.h>
 #import <ComponentKit/CKComponentScopeTypes.h>
 #import <ComponentKit/CKMacros.h>
@@ -42,11 +43,23 @@
 - (void)componentGenerator:(CKComponentGenerator *)componentGenerator didAsynchronouslyGenerateComponentResult:(CKBuildComponentResult)result;
 
 /**
- This is called on the affined queue when a component state update is received.
+ This is called on the affined queue when a component state update is received, or once for all the state updates
+ received before a display refresh if `CKComponentGeneratorOptions.coalescesStateUpdatesUntilNextFrame` is set.
  You should normally call either `generateComponentSynchronously` or `generateComponentAsynchronously` after this delegate method is called.
  */
 - (void)componentGenerator:(CKComponentGenerator *)componentGenerator didReceiveComponentStateUpdateWithMode:(CKUpdateMode)mode;
 
+@optional
+
+/**
+ This is called on the affined queue instead of `componentGenerator:didAsynchronouslyGenerateComponentResult:` when the
+ asynchronous generation also computed the layout of its root component.
+ @see `generateComponentAsynchronouslyWithLayoutSizeRange:`
+ */
+- (void)componentGenerator:(CKComponentGenerator *)componentGenerator
+didAsynchronouslyGenerateComponentResult:(CKBuildComponentResult)result
+                rootLayout:(const CKComponentRootLayout &)rootLayout;
+
 @end
 
 struct CKComponentGeneratorOptions {
@@ -86,6 +99,23 @@ struct CKComponentGeneratorOptions {
    locks when calling methods, which should be avoided unless it's extremely necessary.
    */
   dispatch_queue_t affinedQueue = dispatch_get_main_queue();
+
+  /**
+   If set, the state updates received before the next display refresh are delivered to the delegate as a single update,
+   with the strictest of their update modes, so that they are built in one generation.
+   The size of each batch is reported to `CKAnalyticsListener`.
+   */
+  BOOL coalescesStateUpdatesUntilNextFrame = NO;
+};
+
+/**
+ Counters of the asynchronous generations that were cancelled because a newer asynchronous generation superseded them.
+ */
+struct CKComponentGeneratorCancellationStats {
+  /** The number of cancelled generations. */
+  NSUInteger cancelledGenerations;
+  /** The time the cancelled generations spent building components before they stopped, in seconds. */
+  CFTimeInterval discardedBuildDuration;
 };
 
 /**
@@ -128,9 +158,24 @@ CK_INIT_UNAVAILABLE;
  Generate component asynchronously on a global background queue.
  `CKComponentGeneratorDelegate.componentGenerator:didAsynchronouslyGenerateComponentResult:` will be called once it
  finishes generation.
+
+ An asynchronous generation that is still in flight is cancelled: it stops at its next render component boundary and
+ its result is thrown away, without calling the delegate.
  */
 - (void)generateComponentAsynchronously;
 
+/**
+ Same as `generateComponentAsynchronously`, but also computes the layout of the generated root component within
+ `sizeRange` on the background queue, so that the affined queue only has to mount it. The layout is passed to
+ `componentGenerator:didAsynchronouslyGenerateComponentResult:rootLayout:` if the delegate implements it.
+ */
+- (void)generateComponentAsynchronouslyWithLayoutSizeRange:(const CKSizeRange &)sizeRange;
+
+/**
+ Counters of the asynchronous generations cancelled so far. Can be called from any thread.
+ */
+- (CKComponentGeneratorCancellationStats)cancellationStats;
+
 /**
  Force a complete components reload (ignoring all reuse options) in next component generation.
  This should be used if you are going to update `CKComponentContext` in the hierarchy.
@@ -10,8 +10,11 @@
 
 #import "CKComponentGenerator.h"
 
+#import <atomic>
 #import <mutex>
 
+#import <QuartzCore/QuartzCore.h>
+
 #import <ComponentKit/CKAnalyticsListener.h>
 #import <RenderCore/RCAssert.h>
 #import <ComponentKit/CKBuildComponent.h>
@@ -21,7 +24,9 @@
 #import <ComponentKit/CKComponentScopeRoot.h>
 #import <ComponentKit/CKComponentScopeRootFactory.h>
 #import <ComponentKit/CKDelayedInitialisationWrapper.h>
+#import <ComponentKit/CKGenerationToken.h>
 #import <ComponentKit/CKGlobalConfig.h>
+#import <ComponentKit/CKOptional.h>
 #import <ComponentKit/CKSystraceScope.h>
 #import <ComponentKit/CKTraitCollectionHelper.h>
 
@@ -159,6 +164,67 @@ private:
   }
 };
 
+/**
+ The state updates received since the last display refresh, see `coalescesStateUpdatesUntilNextFrame`.
+ */
+struct CKComponentGeneratorStateUpdateBatch {
+  NSUInteger stateUpdateCount{0};
+  CKUpdateMode mode{CKUpdateModeAsynchronous};
+};
+
+/** Calls a block once, on the main thread, when the display next refreshes. */
+@interface CKComponentGeneratorNextFrameObserver : NSObject
++ (void)performOnNextFrame:(dispatch_block_t)block;
+@end
+
+@implementation CKComponentGeneratorNextFrameObserver
+{
+  dispatch_block_t _block;
+  CADisplayLink *_displayLink;
+}
+
++ (void)performOnNextFrame:(dispatch_block_t)block
+{
+  RCAssertMainThread();
+  CKComponentGeneratorNextFrameObserver *const observer = [self new];
+  observer->_block = block;
+  // The display link retains the observer until it is invalidated.
+  observer->_displayLink = [CADisplayLink displayLinkWithTarget:observer selector:@selector(_displayDidRefresh)];
+  [observer->_displayLink addToRunLoop:[NSRunLoop mainRunLoop] forMode:NSRunLoopCommonModes];
+}
+
+- (void)_displayDidRefresh
+{
+  [_displayLink invalidate];
+  _displayLink = nil;
+  const auto block = _block;
+  _block = nil;
+  block();
+}
+
+@end
+
+/**
+ Counts the asynchronous generations that are cancelled, from the threads that build them.
+ */
+struct CKComponentGeneratorCancellationCounters {
+  void recordCancelledGeneration(CFTimeInterval buildDuration) noexcept {
+    _cancelledGenerations.fetch_add(1, std::memory_order_relaxed);
+    _discardedBuildNanoseconds.fetch_add((uint64_t)(buildDuration * NSEC_PER_SEC), std::memory_order_relaxed);
+  }
+
+  CKComponentGeneratorCancellationStats stats() const noexcept {
+    return {
+      .cancelledGenerations = _cancelledGenerations.load(std::memory_order_relaxed),
+      .discardedBuildDuration = (CFTimeInterval)_discardedBuildNanoseconds.load(std::memory_order_relaxed) / NSEC_PER_SEC,
+    };
+  }
+
+private:
+  std::atomic<NSUInteger> _cancelledGenerations{0};
+  std::atomic<uint64_t> _discardedBuildNanoseconds{0};
+};
+
 @interface CKComponentGenerator () <CKComponentStateListener>
 
 @end
@@ -169,6 +235,10 @@ private:
   __weak id<CKComponentGeneratorDelegate> _delegate;
   std::unique_ptr<CKComponentGeneratorInputsStore> _inputsStore;
   dispatch_queue_t _affinedQueue;
+  std::shared_ptr<CKGenerationToken> _asyncGenerationToken;
+  std::shared_ptr<CKComponentGeneratorCancellationCounters> _cancellationCounters;
+  BOOL _coalescesStateUpdatesUntilNextFrame;
+  CKComponentGeneratorStateUpdateBatch _stateUpdateBatch;
 }
 
 - (instancetype)initWithOptions:(const CKComponentGeneratorOptions &)options
@@ -184,6 +254,8 @@ private:
                                          options.componentControllerPredicates)
     );
     _affinedQueue = options.affinedQueue;
+    _cancellationCounters = std::make_shared<CKComponentGeneratorCancellationCounters>();
+    _coalescesStateUpdatesUntilNextFrame = options.coalescesStateUpdatesUntilNextFrame;
   }
   return self;
 }
@@ -256,21 +328,47 @@ private:
 }
 
 - (void)generateComponentAsynchronously
+{
+  [self _generateComponentAsynchronouslyWithLayoutSizeRange:CK::none];
+}
+
+- (void)generateComponentAsynchronouslyWithLayoutSizeRange:(const CKSizeRange &)sizeRange
+{
+  [self _generateComponentAsynchronouslyWithLayoutSizeRange:sizeRange];
+}
+
+- (void)_generateComponentAsynchronouslyWithLayoutSizeRange:(CK::Optional<CKSizeRange>)layoutSizeRange
 {
   const auto inputs = _inputsStore->acquireInputs(^(CKComponentGeneratorInputs &_inputs){
     return std::make_shared<const CKComponentGeneratorInputs>(_inputs);
   });
+  // The result of the generation in flight would be thrown away once this one is applied.
+  const auto generationToken = _inputsStore->acquireInputs(^(CKComponentGeneratorInputs &_inputs){
+    if (_asyncGenerationToken) {
+      _asyncGenerationToken->cancel();
+    }
+    _asyncGenerationToken = std::make_shared<CKGenerationToken>();
+    return _asyncGenerationToken;
+  });
   const auto asyncGeneration = CK::Analytics::willStartAsyncBlock(CK::Analytics::BlockName::ComponentGeneratorWillGenerate);
   // Avoid capturing `self` in global queue so that `CKComponentGenerator` does not have a chance to be deallocated outside affined queue.
   const auto componentProvider = _componentProvider;
   const auto affinedQueue = _affinedQueue;
+  const auto cancellationCounters = _cancellationCounters;
   __weak const auto weakSelf = self;
   dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
     CKSystraceScope generationScope(asyncGeneration);
+    if (generationToken->isCancelled()) {
+      cancellationCounters->recordCancelledGeneration(0);
+      return;
+    }
+    const CFTimeInterval buildStartTime = CACurrentMediaTime();
     __block std::shared_ptr<const CKBuildComponentResult> result = nullptr;
+    __block std::shared_ptr<const CKComponentRootLayout> rootLayout = nullptr;
     auto const buildTrigger = CKBuildComponentTrigger(inputs->scopeRoot, inputs->stateUpdates, inputs->treeNeedsReflow(), inputs->didUpdateModelOrContext());
     auto const reflowReason = inputs->reflowTrigger(buildTrigger);
     CKPerformWithCurrentTraitCollection(inputs->traitCollection(), ^{
+      CKGenerationToken::Scope generationTokenScope(generationToken.get());
       result = std::make_shared<const CKBuildComponentResult>(CKBuildComponent(
         inputs->scopeRoot,
         inputs->stateUpdates,
@@ -278,7 +376,25 @@ private:
         buildTrigger,
         reflowReason
       ));
+      CKComponentScopeRoot *const scopeRoot = result->scopeRoot;
+      layoutSizeRange.apply([&](const CKSizeRange &sizeRange) {
+        if (!generationToken->isCancelled()) {
+          rootLayout = std::make_shared<const CKComponentRootLayout>(CKComputeRootComponentLayout(result->component,
+                                                                                                  sizeRange,
+                                                                                                  scopeRoot.analyticsListener,
+                                                                                                  result->buildTrigger,
+                                                                                                  scopeRoot));
+        }
+      });
     });
+    const CFTimeInterval buildDuration = CACurrentMediaTime() - buildStartTime;
+    // Drop the partial scope root of a cancelled generation right away.
+    if (generationToken->isCancelled()) {
+      result = nullptr;
+      rootLayout = nullptr;
+      cancellationCounters->recordCancelledGeneration(buildDuration);
+      return;
+    }
     const auto addedComponentControllers =
     std::make_shared<const std::vector<CKComponentController *>>(_addedComponentControllersBetweenScopeRoots(result->scopeRoot, inputs->scopeRoot));
     const auto invalidComponentControllers =
@@ -291,6 +407,11 @@ private:
       if (!strongSelf) {
         return;
       }
+      // A newer generation started while this one was waiting for the affined queue.
+      if (generationToken->isCancelled()) {
+        cancellationCounters->recordCancelledGeneration(buildDuration);
+        return;
+      }
       if (![strongSelf->_delegate componentGeneratorShouldApplyAsynchronousGenerationResult:strongSelf]) {
         return;
       }
@@ -308,7 +429,11 @@ private:
         }
       });
       if (shouldRetry) {
-        [strongSelf generateComponentAsynchronously];
+        [strongSelf _generateComponentAsynchronouslyWithLayoutSizeRange:layoutSizeRange];
+      } else if (rootLayout != nullptr &&
+                 [strongSelf->_delegate respondsToSelector:@selector(componentGenerator:didAsynchronouslyGenerateComponentResult:rootLayout:)]) {
+        id<CKComponentGeneratorDelegate> delegate = strongSelf->_delegate;
+        [delegate componentGenerator:strongSelf didAsynchronouslyGenerateComponentResult:*result rootLayout:*rootLayout];
       } else {
         if (CKReadGlobalConfig().clangCStructLeakWorkaroundEnabled) {
           id<CKComponentGeneratorDelegate> delegate = strongSelf->_delegate;
@@ -329,6 +454,11 @@ private:
   });
 }
 
+- (CKComponentGeneratorCancellationStats)cancellationStats
+{
+  return _cancellationCounters->stats();
+}
+
 - (void)forceReloadInNextGeneration
 {
   _inputsStore->acquireInputs(^(CKComponentGeneratorInputs &inputs){
@@ -429,7 +559,11 @@ static std::vector<CKComponentController *> _addedComponentControllersBetweenSco
       inputs.stateUpdates[handle].push_back(stateUpdate);
       [[inputs.scopeRoot analyticsListener] didReceiveStateUpdateFromScopeHandle:handle rootIdentifier:rootIdentifier];
     });
-    [_delegate componentGenerator:self didReceiveComponentStateUpdateWithMode:mode];
+    if (_coalescesStateUpdatesUntilNextFrame) {
+      [self _addStateUpdateToBatchWithMode:mode];
+    } else {
+      [_delegate componentGenerator:self didReceiveComponentStateUpdateWithMode:mode];
+    }
   };
   if (_affinedQueue == dispatch_get_main_queue()) {
     enqueueStateUpdate();
@@ -441,6 +575,67 @@ static std::vector<CKComponentController *> _addedComponentControllersBetweenSco
   }
 }
 
+- (void)_addStateUpdateToBatchWithMode:(CKUpdateMode)mode
+{
+  const auto startsBatch = _inputsStore->acquireInputs(^(CKComponentGeneratorInputs &inputs){
+    _stateUpdateBatch.stateUpdateCount++;
+    _stateUpdateBatch.mode = _strictestUpdateMode(_stateUpdateBatch.mode, mode);
+    return _stateUpdateBatch.stateUpdateCount == 1;
+  });
+  if (!startsBatch) {
+    return;
+  }
+
+  __weak const auto weakSelf = self;
+  const auto affinedQueue = _affinedQueue;
+  const auto scheduleBatch = ^{
+    [CKComponentGeneratorNextFrameObserver performOnNextFrame:^{
+      if (affinedQueue == nil || affinedQueue == dispatch_get_main_queue()) {
+        [weakSelf _deliverStateUpdateBatch];
+      } else {
+        dispatch_async(affinedQueue, ^{
+          [weakSelf _deliverStateUpdateBatch];
+        });
+      }
+    }];
+  };
+  if ([NSThread isMainThread]) {
+    scheduleBatch();
+  } else {
+    dispatch_async(dispatch_get_main_queue(), scheduleBatch);
+  }
+}
+
+- (void)_deliverStateUpdateBatch
+{
+  __block CKComponentScopeRoot *scopeRoot;
+  __block BOOL hasPendingStateUpdates;
+  const auto batch = _inputsStore->acquireInputs(^(CKComponentGeneratorInputs &inputs){
+    scopeRoot = inputs.scopeRoot;
+    hasPendingStateUpdates = !inputs.stateUpdates.empty();
+    const auto stateUpdateBatch = _stateUpdateBatch;
+    _stateUpdateBatch = {};
+    return stateUpdateBatch;
+  });
+  if (batch.stateUpdateCount == 0) {
+    return;
+  }
+  [[scopeRoot analyticsListener] didCoalesceStateUpdates:batch.stateUpdateCount
+                                                withMode:batch.mode
+                                          rootIdentifier:[scopeRoot globalIdentifier]];
+  // A generation built since the state updates were received may already have applied them.
+  if (hasPendingStateUpdates) {
+    [_delegate componentGenerator:self didReceiveComponentStateUpdateWithMode:batch.mode];
+  }
+}
+
+static CKUpdateMode _strictestUpdateMode(CKUpdateMode mode1, CKUpdateMode mode2)
+{
+  return (mode1 == CKUpdateModeSynchronous || mode2 == CKUpdateModeSynchronous)
+  ? CKUpdateModeSynchronous
+  : CKUpdateModeAsynchronous;
+}
+
 + (BOOL)requiresMainThreadAffinedStateUpdates
 {
   return YES;
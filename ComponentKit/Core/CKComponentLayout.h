@@ -16,6 +16,7 @@
 #import <ComponentKit/CKBuildTrigger.h>
 #import <ComponentKit/RCLayout.h>
 #import <ComponentKit/CKOptional.h>
+#import <ComponentKit/RCPersistentMap.h>
 #import <ComponentKit/CKComponentScopeTypes.h>
 #import <RenderCoreLayoutCaching/RCComputeRootLayout.h>
 
@@ -25,23 +26,41 @@
 struct RCLayoutResult;
 struct RCLayoutCache;
 
+/**
+ The layout caches of all the trees of a data source, by scope root.
+
+ Backed by a persistent map: copying a CKTreeLayoutCache to hand a snapshot to a modification is O(1), and updating or
+ erasing the cache of one tree is O(log n) and doesn't affect existing snapshots.
+ */
 struct CKTreeLayoutCache {
+  CKTreeLayoutCache(RCLayoutCacheBackend backend = RCLayoutCacheBackendPersistentMap) : backend(backend) {}
+
+  /** Returns the layout cache of the given scope root, or an empty cache using this tree's backend. */
   std::shared_ptr<RCLayoutCache> find(CKComponentScopeRootIdentifier key) const
   {
     auto match = map.find(key);
-    if (match != map.end()) {
-      return match->second;
+    if (match != nullptr && *match != nullptr) {
+      return *match;
     }
-    return nullptr;
+    return RCLayoutCacheCreate(backend);
   }
 
   void update(CKComponentScopeRootIdentifier key, std::shared_ptr<RCLayoutCache> layoutCache)
   {
-    map.emplace(std::make_pair(key, std::move(layoutCache)));
+    map = map.insert(key, std::move(layoutCache));
+  }
+
+  /** Drops the layout cache of a scope root whose item was removed. */
+  void erase(CKComponentScopeRootIdentifier key)
+  {
+    map = map.erase(key);
   }
+
+  size_t size() const { return map.size(); }
   
 private:
-  std::unordered_map<CKComponentScopeRootIdentifier, std::shared_ptr<RCLayoutCache>, RC::hash<CKComponentScopeRootIdentifier>> map;
+  RCLayoutCacheBackend backend;
+  RC::PersistentMap<CKComponentScopeRootIdentifier, std::shared_ptr<RCLayoutCache>> map;
 };
 
 /**
@@ -54,12 +73,39 @@ private:
  @param supercomponent Usually pass nil; if you are mounting a subtree of a layout, pass the parent component so the
         component responder chain can be connected correctly.
  @param analyticsListener analytics listener used to log mount time.
+ @param incrementalMountState If non-null, unchanged subtrees are skipped. See RCIncrementalMountState.
  */
 NSSet<id<CKMountable>> *CKMountComponentLayout(const RCLayout &layout,
                                                UIView *view,
                                                NSSet<id<CKMountable>> *previouslyMountedComponents,
                                                id<CKMountable> supercomponent,
-                                               id<CKAnalyticsListener> analyticsListener = nil);
+                                               id<CKAnalyticsListener> analyticsListener = nil,
+                                               RCIncrementalMountState *incrementalMountState = nullptr);
+
+/**
+ Same as CKMountComponentLayout, but spreads the mount over several runloop turns so that mounting a large layout does
+ not block the main thread for more than `frameBudget` seconds at a time.
+
+ The first slice is mounted synchronously. Components are mounted in the same order as CKMountComponentLayout, and
+ components in previouslyMountedComponents that are not in the new layout are unmounted only once the whole layout is
+ mounted. The mount is abandoned if the returned object is released before it finishes; see RCResumableLayoutMount for
+ what to pass as previously mounted components in that case.
+
+ Until the completion is called, the view shows a mix of both layouts: the components mounted so far are in their new
+ position and state, next to the components of the previous layout that were not mounted again yet, and to the ones that
+ are not part of the new layout anymore. Don't mount another layout in the same view, or rely on its contents being
+ consistent (e.g. for hit testing or snapshots), until then.
+
+ @param frameBudget Time spent mounting per runloop turn, in seconds.
+ @param completion Called on the main thread with the mounted components once the whole layout is mounted.
+ */
+std::shared_ptr<RCResumableLayoutMount> CKMountComponentLayoutTimeSliced(const RCLayout &layout,
+                                                                         UIView *view,
+                                                                         NSSet<id<CKMountable>> *previouslyMountedComponents,
+                                                                         id<CKMountable> supercomponent,
+                                                                         id<CKAnalyticsListener> analyticsListener,
+                                                                         CFTimeInterval frameBudget,
+                                                                         void(^completion)(NSSet<id<CKMountable>> *mountedComponents));
 
 struct CKComponentRootLayout { // This is pending renaming
   /** Layout cache for components that have controller. */
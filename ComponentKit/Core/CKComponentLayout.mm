@@ -14,6 +14,8 @@
 #import <ComponentKit/CKComponentAnimationPredicates.h>
 #import <ComponentKit/CKComponentInternal.h>
 #import <ComponentKit/CKComponentSubclass.h>
+#import <ComponentKit/CKEmptyComponent.h>
+#import <ComponentKit/CKRootTreeNode.h>
 #import <ComponentKit/CKTreeVerificationHelpers.h>
 #import <ComponentKit/ComponentLayoutContext.h>
 #import <ComponentKit/CKComponentScopeRoot.h>
@@ -24,7 +26,8 @@ NSSet<id<CKMountable>> *CKMountComponentLayout(const RCLayout &layout,
                                                UIView *view,
                                                NSSet<id<CKMountable>> *previouslyMountedComponents,
                                                id<CKMountable> supercomponent,
-                                               id<CKAnalyticsListener> analyticsListener)
+                                               id<CKAnalyticsListener> analyticsListener,
+                                               RCIncrementalMountState *incrementalMountState)
 {
   ((CKComponent *)layout.component).rootComponentMountedView = view;
   [analyticsListener willMountComponentTreeWithRootComponent:layout.component];
@@ -39,7 +42,8 @@ NSSet<id<CKMountable>> *CKMountComponentLayout(const RCLayout &layout,
                 previouslyMountedComponents,
                 supercomponent,
                 collectMountAnalytics ? &mountAnalyticsContext : nullptr,
-                analyticsListener.systraceListener);
+                analyticsListener.systraceListener,
+                incrementalMountState);
   [analyticsListener
    didMountComponentTreeWithRootComponent:layout.component
    mountAnalyticsContext:
@@ -49,22 +53,149 @@ NSSet<id<CKMountable>> *CKMountComponentLayout(const RCLayout &layout,
   return mountedComponents;
 }
 
-static auto buildComponentsByPredicateMap(const RCLayout &layout,
-                                          const std::unordered_set<CKMountablePredicate> &predicates)
+static void mountNextSlice(std::weak_ptr<RCResumableLayoutMount> weakMount,
+                           CFTimeInterval frameBudget,
+                           dispatch_block_t didFinish)
 {
+  dispatch_async(dispatch_get_main_queue(), ^{
+    const auto mount = weakMount.lock();
+    if (mount == nullptr) {
+      return; // Abandoned by the caller.
+    }
+    if (mount->mountUntil(CACurrentMediaTime() + frameBudget)) {
+      didFinish();
+    } else {
+      mountNextSlice(weakMount, frameBudget, didFinish);
+    }
+  });
+}
+
+std::shared_ptr<RCResumableLayoutMount> CKMountComponentLayoutTimeSliced(const RCLayout &layout,
+                                                                         UIView *view,
+                                                                         NSSet<id<CKMountable>> *previouslyMountedComponents,
+                                                                         id<CKMountable> supercomponent,
+                                                                         id<CKAnalyticsListener> analyticsListener,
+                                                                         CFTimeInterval frameBudget,
+                                                                         void(^completion)(NSSet<id<CKMountable>> *mountedComponents))
+{
+  RCCAssertMainThread();
+  ((CKComponent *)layout.component).rootComponentMountedView = view;
+  [analyticsListener willMountComponentTreeWithRootComponent:layout.component];
+
+  const BOOL collectMountAnalytics =
+  [analyticsListener shouldCollectMountInformationForRootComponent:layout.component];
+  // Outlives this call since the mount continues on later runloop turns.
+  const auto mountAnalyticsContext = std::make_shared<CK::Component::MountAnalyticsContext>();
+
+  const auto mount = std::make_shared<RCResumableLayoutMount>(layout,
+                                                              view,
+                                                              previouslyMountedComponents,
+                                                              supercomponent,
+                                                              collectMountAnalytics ? mountAnalyticsContext.get() : nullptr,
+                                                              analyticsListener.systraceListener);
+  const std::weak_ptr<RCResumableLayoutMount> weakMount = mount;
+  id<CKMountable> const rootComponent = layout.component;
+  const dispatch_block_t didFinish = ^{
+    [analyticsListener
+     didMountComponentTreeWithRootComponent:rootComponent
+     mountAnalyticsContext:
+     collectMountAnalytics
+     ? CK::Optional<CK::Component::MountAnalyticsContext> {*mountAnalyticsContext}
+     : CK::none];
+    if (completion) {
+      const auto finishedMount = weakMount.lock();
+      completion(finishedMount ? finishedMount->mountedComponents() : nil);
+    }
+  };
+
+  if (mount->mountUntil(CACurrentMediaTime() + frameBudget)) {
+    didFinish();
+  } else {
+    mountNextSlice(weakMount, frameBudget, didFinish);
+  }
+  return mount;
+}
+
+/**
+ Walks the layout tree once, without recursion, and fills all the outputs of the post-layout processing: the layout
+ lookup for components with controllers, the components matching each animation predicate, and (in builds with
+ assertions) the duplicate component detection and the tree node to parent links verification.
+ */
+static CKComponentRootLayout buildRootLayout(const RCLayoutResult &layoutResult, CKComponentScopeRoot *scopeRoot)
+{
+  auto layoutLookup = CKComponentRootLayout::ComponentLayoutCache {};
   auto componentsByPredicate = CKComponentRootLayout::ComponentsByPredicateMap {};
-  if (predicates.empty()) {
-    return componentsByPredicate;
+
+  const auto predicates = CKComponentAnimationPredicates();
+
+  struct Item {
+    const RCLayout *layout;
+    CKTreeNode *parentNode;
+  };
+  CKTreeNode *rootParentNode = nil;
+#if CK_ASSERTIONS_ENABLED
+  NSMutableSet<id<CKMountable>> *const seenComponents = [NSMutableSet new];
+  BOOL hasDuplicateComponent = NO;
+  const BOOL verifyTreeNodes = scopeRoot.hasRenderComponentInTree;
+  if (verifyTreeNodes) {
+    rootParentNode = scopeRoot.rootNode.node();
   }
-  layout.enumerateLayouts([&](const auto &l){
-    if (l.component == nil) { return; }
-    for (const auto &p : predicates) {
-      if (p(l.component)) {
-        componentsByPredicate[p].push_back(l.component);
+#endif
+
+  // Children are pushed in reverse order so that components are visited in the same pre-order as enumerateLayouts.
+  std::vector<Item> stack {{&layoutResult.layout, rootParentNode}};
+  while (!stack.empty()) {
+    const auto item = stack.back();
+    stack.pop_back();
+    const RCLayout &l = *item.layout;
+    id<CKMountable> const component = l.component;
+    if (component == nil) {
+      continue;
+    }
+
+    if ([component isKindOfClass:[CKComponent class]] && ((CKComponent *)component).controller) {
+      layoutLookup[component] = l;
+    }
+
+    for (const auto &predicate : predicates) {
+      if (predicate(component)) {
+        componentsByPredicate[predicate].push_back(component);
       }
     }
-  });
-  return componentsByPredicate;
+
+    CKTreeNode *parentNodeForChildren = item.parentNode;
+#if CK_ASSERTIONS_ENABLED
+    if (component.class != CKEmptyComponent.class) {
+      if ([seenComponents containsObject:component]) {
+        hasDuplicateComponent = YES;
+      } else {
+        [seenComponents addObject:component];
+      }
+    }
+    if (verifyTreeNodes) {
+      parentNodeForChildren = CKVerifyTreeNodeToParentLink(scopeRoot, component, item.parentNode);
+    }
+#endif
+
+    if (l.children) {
+      for (auto it = l.children->rbegin(); it != l.children->rend(); ++it) {
+        stack.push_back({&it->layout, parentNodeForChildren});
+      }
+    }
+  }
+
+#if CK_ASSERTIONS_ENABLED
+  if (hasDuplicateComponent) {
+    // Rare; walk the tree again to build a useful backtrace.
+    CKDetectDuplicateComponent(layoutResult.layout);
+  }
+#endif
+
+  return CKComponentRootLayout {
+    layoutResult,
+    std::move(layoutLookup),
+    std::move(componentsByPredicate),
+  };
 }
 
 CKComponentRootLayout CKComputeRootComponentLayout(id<CKMountable> rootComponent,
@@ -84,21 +215,13 @@ CKComponentRootLayout CKComputeRootComponentLayout(id<CKMountable> rootComponent
     layoutResult = {CKComputeComponentLayout(rootComponent, sizeRange, sizeRange.max), nil};
   }
 
-  auto layoutLookup = CKComponentRootLayout::ComponentLayoutCache {};
-  layoutResult.layout.enumerateLayouts([&](const auto &l){
-    if ([l.component isKindOfClass:[CKComponent class]] && ((CKComponent *)l.component).controller) {
-      layoutLookup[l.component] = l;
-    }
-  });
-  const auto componentsByPredicate = buildComponentsByPredicateMap(layoutResult.layout, CKComponentAnimationPredicates());
-  const auto rootLayout = CKComponentRootLayout {
-    layoutResult,
-    layoutLookup,
-    componentsByPredicate,
-  };
-
-  CKDetectDuplicateComponent(rootLayout.layout());
-  CKVerifyTreeNodesToParentLinks(scopeRoot, rootLayout.layout());
+  if (analyticsListener == nil) {
+    return buildRootLayout(layoutResult, scopeRoot);
+  }
+  const CFTimeInterval processingStartTime = CACurrentMediaTime();
+  const auto rootLayout = buildRootLayout(layoutResult, scopeRoot);
+  [analyticsListener didProcessLayoutOfComponentTreeWithRootComponent:rootComponent
+                                                             duration:CACurrentMediaTime() - processingStartTime];
   [analyticsListener didLayoutComponentTreeWithRootComponent:rootComponent];
   return rootLayout;
 }
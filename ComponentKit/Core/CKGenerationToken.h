@@ -0,0 +1,52 @@
+/*
+ *  Copyright (c) 2014-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#import <ComponentKit/CKDefines.h>
+
+#if CK_NOT_SWIFT
+
+#import <atomic>
+
+/**
+ Cancels a generation that is built asynchronously once a newer one supersedes it.
+
+ The build of a generation checks the token of its thread at render component boundaries, and stops early once it
+ is cancelled; whatever it returns must then be thrown away. A build only writes to the scope root it creates, so the
+ previous generation is left as it was. Layout is never interrupted. See CKComponentGenerator.
+ */
+class CKGenerationToken {
+public:
+  /** Stops the generations built with this token at their next boundary. Can be called from any thread. */
+  void cancel() noexcept { _cancelled.store(true, std::memory_order_relaxed); }
+  bool isCancelled() const noexcept { return _cancelled.load(std::memory_order_relaxed); }
+
+  /** The token of the current thread, or null. */
+  static CKGenerationToken *current() noexcept;
+  /** Whether the current thread builds a generation that has been cancelled. */
+  static bool isCurrentCancelled() noexcept;
+
+  /** Sets the token of the current thread while it is alive. */
+  class Scope {
+  public:
+    Scope(CKGenerationToken *token) noexcept;
+    ~Scope();
+
+  private:
+    CKGenerationToken *_previousToken;
+
+    Scope(const Scope&) = delete;
+    Scope &operator=(const Scope&) = delete;
+  };
+
+private:
+  std::atomic<bool> _cancelled{false};
+};
+
+#endif
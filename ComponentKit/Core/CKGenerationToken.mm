@@ -0,0 +1,33 @@
+/*
+ *  Copyright (c) 2014-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#import "CKGenerationToken.h"
+
+static thread_local CKGenerationToken *currentToken;
+
+CKGenerationToken *CKGenerationToken::current() noexcept
+{
+  return currentToken;
+}
+
+bool CKGenerationToken::isCurrentCancelled() noexcept
+{
+  return currentToken != nullptr && currentToken->isCancelled();
+}
+
+CKGenerationToken::Scope::Scope(CKGenerationToken *token) noexcept : _previousToken(currentToken)
+{
+  currentToken = token;
+}
+
+CKGenerationToken::Scope::~Scope()
+{
+  currentToken = _previousToken;
+}
@@ -28,6 +28,13 @@ struct CKComponentContextContents {
   bool operator!=(const CKComponentContextContents&) const;
 };
 
+/**
+ An immutable snapshot of the items stored in CKComponentContext. Snapshots share the storage of the items, so taking
+ one is O(1).
+ */
+@interface CKComponentContextSnapshot : NSObject
+@end
+
 /** Internal helper class. Avoid using this externally. */
 struct CKComponentContextHelper {
   static CKComponentContextPreviousState store(id key, id object) noexcept;
@@ -35,13 +42,21 @@ struct CKComponentContextHelper {
   static id fetch(id key) noexcept; // Fetch value from CKComponentContext.
   static id fetchMutable(id key) noexcept; // Fetch value from CKComponentMutableContext.
 
-  /** Creates a backup of the existing store, in the renderToDictionary map */
+  /** Keeps a snapshot of the existing store, in the renderToSnapshot map */
   static void didCreateRenderComponent(id component) noexcept;
-  /** Pushes the existing store into a stack and change it with the one from the component's backup */
+  /** Pushes the existing store into a stack and change it with the component's snapshot */
   static void willBuildComponentTree(id component) noexcept;
   /** Restores the previous store from the stack */
   static void didBuildComponentTree(id component) noexcept;
 
+  /**
+   Moves the store a render component is to be built with out of the current thread, to build it on another thread with
+   setComponentTreeContext. Returns nil if there is no store.
+   */
+  static CKComponentContextSnapshot *takeComponentTreeContext(id component) noexcept;
+  /** Sets the store the render component is built with on the current thread, see takeComponentTreeContext */
+  static void setComponentTreeContext(id component, CKComponentContextSnapshot *snapshot) noexcept;
+
   /**
    Returns a structure with all the items that are currently in CKComponentContext.
    This could be used to bridge CKComponentContext items to another language or system.
@@ -63,11 +78,11 @@ public:
 
 private:
   /** Provides a way to set initial context values. */
-  static NSMutableDictionary<Class, id>* setInitialValues(NSDictionary<Class, id> *objects) noexcept;
+  static CKComponentContextSnapshot *setInitialValues(NSDictionary<Class, id> *objects) noexcept;
   /** Provide a way to clean the initial values that were set with `setInitialValues`.*/
-  static void cleanInitialValues(NSMutableDictionary<Class, id> *oldObjects) noexcept;
+  static void cleanInitialValues(CKComponentContextSnapshot *oldObjects) noexcept;
   /** Save the old objects. */
-  NSMutableDictionary *_oldObjects;
+  CKComponentContextSnapshot *_oldObjects;
 
   CKComponentInitialValuesContext(const CKComponentInitialValuesContext&) = delete;
   CKComponentInitialValuesContext &operator=(const CKComponentInitialValuesContext&) = delete;
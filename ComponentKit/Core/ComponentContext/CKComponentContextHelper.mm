@@ -14,42 +14,81 @@
 #import <ComponentKit/CKComponentScopeRoot.h>
 #import <ComponentKit/CKThreadLocalComponentScope.h>
 #import <ComponentKit/CKRootTreeNode.h>
+#import <ComponentKit/RCPersistentMap.h>
 
 #import <stack>
 
-static NSString *const kThreadDictionaryKey = @"CKComponentContext";
+// Context keys are classes, which are equal only to themselves.
+struct CKComponentContextKeyHash {
+  size_t operator()(id key) const noexcept
+  {
+    return std::hash<void *>()((__bridge void *)key);
+  }
+};
+
+using CKComponentContextStore = RC::PersistentMap<id, id, CKComponentContextKeyHash>;
+
+@interface CKComponentContextSnapshot ()
+{
+@public
+  CKComponentContextStore _store;
+}
+@end
+@implementation CKComponentContextSnapshot @end
 
 struct CKComponentContextStackItem {
-  NSMutableDictionary *dictionary;
+  CKComponentContextStore store;
+  CKComponentContextSnapshot *snapshot;
   BOOL itemWasAdded;
 };
 
-@interface CKComponentContextValue : NSObject
-{
-@public
+struct CKComponentContextState {
   // The main store.
-  NSMutableDictionary *_dictionary;
-  // A map between render component to its dictionary.
-  NSMapTable<id, NSMutableDictionary *> *_renderToDictionaryCache;
-  // Stack of previous store dictionaries.
-  std::stack<CKComponentContextStackItem> _stack;
+  CKComponentContextStore store;
+  // The snapshot of the main store, created on demand and shared until the store changes.
+  CKComponentContextSnapshot *snapshot;
+  // A map between render component to the snapshot it is built with.
+  NSMapTable<id, CKComponentContextSnapshot *> *renderToSnapshotCache;
+  // Stack of previous stores.
+  std::stack<CKComponentContextStackItem> stack;
   // Dirty flag for the current store in use.
-  BOOL _itemWasAdded;
+  BOOL itemWasAdded;
+};
+
+static thread_local CKComponentContextState contextState;
+
+static CKComponentContextSnapshot *currentSnapshot(CKComponentContextState &state)
+{
+  if (state.snapshot == nil) {
+    state.snapshot = [CKComponentContextSnapshot new];
+    state.snapshot->_store = state.store;
+  }
+  return state.snapshot;
 }
-@end
-@implementation CKComponentContextValue @end
 
-static CKComponentContextValue *contextValue(BOOL create)
+static void setStore(CKComponentContextState &state, CKComponentContextStore store)
 {
-  NSMutableDictionary *const threadDictionary = [[NSThread currentThread] threadDictionary];
-  CKComponentContextValue *contextValue = threadDictionary[kThreadDictionaryKey];
-  if (contextValue == nil && create) {
-    contextValue = [CKComponentContextValue new];
-    contextValue->_dictionary = [NSMutableDictionary dictionary];
-    contextValue->_renderToDictionaryCache = [NSMapTable weakToStrongObjectsMapTable];
-    threadDictionary[kThreadDictionaryKey] = contextValue;
+  state.store = std::move(store);
+  state.snapshot = nil;
+}
+
+static NSMapTable<id, CKComponentContextSnapshot *> *renderToSnapshotCache(CKComponentContextState &state)
+{
+  if (state.renderToSnapshotCache == nil) {
+    state.renderToSnapshotCache = [NSMapTable weakToStrongObjectsMapTable];
   }
-  return contextValue;
+  return state.renderToSnapshotCache;
+}
+
+static BOOL hasContext(const CKComponentContextState &state)
+{
+  return !state.store.empty() || state.renderToSnapshotCache.count > 0;
+}
+
+static id valueForKey(const CKComponentContextStore &store, id key)
+{
+  auto const value = store.find(key);
+  return value != nullptr ? *value : nil;
 }
 
 bool CKComponentContextContents::operator==(const CKComponentContextContents &other) const
@@ -62,153 +101,165 @@ bool CKComponentContextContents::operator!=(const CKComponentContextContents &ot
   return !(*this == other);
 }
 
-static void clearContextValueIfEmpty(CKComponentContextValue *const currentValue)
+static void clearContextStateIfEmpty(CKComponentContextState &state)
 {
-  if ([currentValue->_dictionary count] == 0 && currentValue->_renderToDictionaryCache.count == 0) {
-    [[[NSThread currentThread] threadDictionary] removeObjectForKey:kThreadDictionaryKey];
+  if (!hasContext(state)) {
+    state.snapshot = nil;
+    state.renderToSnapshotCache = nil;
+    state.stack = {};
+    state.itemWasAdded = NO;
   }
 }
 
 CKComponentContextPreviousState CKComponentContextHelper::store(id key, id object) noexcept
 {
-  CKComponentContextValue *v = contextValue(YES);
-  NSMutableDictionary *const c = v->_dictionary;
-  id originalValue = c[key];
-  c[key] = object;
-  v->_itemWasAdded = YES;
-  CKComponentContextPreviousState state = {.key = key, .originalValue = originalValue, .newValue = object};
-  return state;
+  CKComponentContextState &state = contextState;
+  id originalValue = valueForKey(state.store, key);
+  setStore(state, object ? state.store.insert(key, object) : state.store.erase(key));
+  state.itemWasAdded = YES;
+  CKComponentContextPreviousState previousState = {.key = key, .originalValue = originalValue, .newValue = object};
+  return previousState;
 }
 
 void CKComponentContextHelper::restore(const CKComponentContextPreviousState &storeResult) noexcept
 {
-  // We want to create the context dictionary if it doesn't exist already, because we need to restore the original
-  // value. In practice it should always exist already except for an obscure edge case; see the unit test
-  // testTriplyNestedComponentContextWithNilMiddleValueCorrectlyRestoresOuterValue for an example.
-  CKComponentContextValue *const v = contextValue(YES);
-  NSMutableDictionary *const c = v->_dictionary;
-  id<NSCopying> storeResultKey = (id<NSCopying>)storeResult.key;
-  RCCAssert(c[storeResultKey] == storeResult.newValue, @"Context value for %@ unexpectedly mutated", storeResult.key);
-  c[storeResultKey] = storeResult.originalValue;
-  clearContextValueIfEmpty(v);
+  CKComponentContextState &state = contextState;
+  RCCAssert(valueForKey(state.store, storeResult.key) == storeResult.newValue,
+            @"Context value for %@ unexpectedly mutated", storeResult.key);
+  setStore(state, storeResult.originalValue
+           ? state.store.insert(storeResult.key, storeResult.originalValue)
+           : state.store.erase(storeResult.key));
+  clearContextStateIfEmpty(state);
 }
 
 void CKComponentContextHelper::didCreateRenderComponent(id component) noexcept
 {
-  CKComponentContextValue *const v = contextValue(NO);
-  if (!v) {
-    return;
-  }
-
-  // Make a backup dictionary if needed and store it in the _renderToDictionaryCache map.
-  if (v->_itemWasAdded) {
-    NSMutableDictionary *renderDictionary = [v->_dictionary mutableCopy];
-    [v->_renderToDictionaryCache setObject:renderDictionary forKey:component];
+  CKComponentContextState &state = contextState;
+  // Keep a snapshot of the store in the renderToSnapshotCache map if needed; it is shared with all the render
+  // components created until the store changes.
+  if (state.itemWasAdded) {
+    [renderToSnapshotCache(state) setObject:currentSnapshot(state) forKey:component];
   }
 }
 
 void CKComponentContextHelper::willBuildComponentTree(id component) noexcept
 {
-  CKComponentContextValue *const v = contextValue(NO);
-  if (!v) {
-    return;
-  }
-
-  NSMutableDictionary *renderDictionary = [v->_renderToDictionaryCache objectForKey:component];
-  if (renderDictionary) {
+  CKComponentContextState &state = contextState;
+  CKComponentContextSnapshot *const snapshot = [state.renderToSnapshotCache objectForKey:component];
+  if (snapshot) {
     // Push the current store into the stack.
-    v->_stack.push({
-      .dictionary = v->_dictionary,
-      .itemWasAdded = v->_itemWasAdded,
+    state.stack.push({
+      .store = state.store,
+      .snapshot = state.snapshot,
+      .itemWasAdded = state.itemWasAdded,
     });
-    // Update the pointer to the latest render dictionary
-    v->_dictionary = renderDictionary;
-    v->_itemWasAdded = NO;
+    // Build the component with the store it was created with.
+    state.store = snapshot->_store;
+    state.snapshot = snapshot;
+    state.itemWasAdded = NO;
   }
 }
 
 void CKComponentContextHelper::didBuildComponentTree(id component) noexcept
 {
-  CKComponentContextValue *const v = contextValue(NO);
-  if (!v) {
-    return;
-  }
+  CKComponentContextState &state = contextState;
+  if ([state.renderToSnapshotCache objectForKey:component]) {
+    RCCAssert(!state.stack.empty(), @"The stack cannot be empty if there is a render snapshot in the cache");
 
-  NSMutableDictionary *renderDictionary = [v->_renderToDictionaryCache objectForKey:component];
-  if (renderDictionary) {
-    RCCAssert(!v->_stack.empty(), @"The stack cannot be empty if there is a render dictionary in the cache");
-    RCCAssert(v->_dictionary == renderDictionary, @"The current store is different than the renderDictionary");
-
-    // Update the pointer to the latest render dictionary
-    if (!v->_stack.empty()) {
-      // Retrieve the previous value from the stack.
-      auto const &topItem = v->_stack.top();
-      v->_dictionary = topItem.dictionary;
-      v->_itemWasAdded = topItem.itemWasAdded;
+    if (!state.stack.empty()) {
+      // Retrieve the previous store from the stack.
+      auto const &topItem = state.stack.top();
+      state.store = topItem.store;
+      state.snapshot = topItem.snapshot;
+      state.itemWasAdded = topItem.itemWasAdded;
       // Pop the top backup from the stack
-      v->_stack.pop();
-      // Remove the dictionary from the map
-      [v->_renderToDictionaryCache removeObjectForKey:component];
+      state.stack.pop();
+      // Remove the snapshot from the map
+      [state.renderToSnapshotCache removeObjectForKey:component];
     }
-    clearContextValueIfEmpty(v);
+    clearContextStateIfEmpty(state);
+  }
+}
+
+CKComponentContextSnapshot *CKComponentContextHelper::takeComponentTreeContext(id component) noexcept
+{
+  CKComponentContextState &state = contextState;
+  CKComponentContextSnapshot *const snapshot = [state.renderToSnapshotCache objectForKey:component];
+  if (snapshot) {
+    [state.renderToSnapshotCache removeObjectForKey:component];
+    clearContextStateIfEmpty(state);
+    return snapshot;
+  }
+  return state.store.empty() ? nil : currentSnapshot(state);
+}
+
+void CKComponentContextHelper::setComponentTreeContext(id component, CKComponentContextSnapshot *snapshot) noexcept
+{
+  if (snapshot) {
+    [renderToSnapshotCache(contextState) setObject:snapshot forKey:component];
   }
 }
 
 id CKComponentContextHelper::fetchMutable(id key) noexcept
 {
-  CKComponentContextValue *const v = contextValue(NO);
-  if (v) {
+  CKComponentContextState &state = contextState;
+  if (hasContext(state)) {
     // Props updates support.
     CKThreadLocalComponentScope *currentScope = CKThreadLocalComponentScope::currentScope();
     if (currentScope != nullptr) {
       [currentScope->newScopeRoot rootNode].markTopRenderComponentAsDirtyForPropsUpdates();
     }
-    return v->_dictionary[key];
+    return valueForKey(state.store, key);
   }
   return nil;
 }
 
 id CKComponentContextHelper::fetch(id key) noexcept
 {
-  CKComponentContextValue *const v = contextValue(NO);
-  if (v) {
-    return v->_dictionary[key];
-  }
-  return nil;
+  return valueForKey(contextState.store, key);
 }
 
 CKComponentContextContents CKComponentContextHelper::fetchAll() noexcept
 {
-  CKComponentContextValue *const v = contextValue(NO);
-  if (!v) {
+  const CKComponentContextStore &store = contextState.store;
+  if (store.empty()) {
     return {};
   }
 
+  NSMutableDictionary<Class, id> *const objects = [NSMutableDictionary dictionaryWithCapacity:store.size()];
+  store.forEach([&](id key, id value) {
+    objects[key] = value;
+  });
   return {
-    .objects = [v->_dictionary copy],
+    .objects = [objects copy],
   };
 }
 
-NSMutableDictionary<Class, id>* CKComponentInitialValuesContext::setInitialValues(NSDictionary<Class, id> *objects) noexcept
+CKComponentContextSnapshot *CKComponentInitialValuesContext::setInitialValues(NSDictionary<Class, id> *objects) noexcept
 {
-  CKComponentContextValue *const v = contextValue(YES);
+  CKComponentContextState &state = contextState;
   // Save the old values.
-  auto const oldObjects = v->_dictionary;
+  CKComponentContextSnapshot *const oldSnapshot = currentSnapshot(state);
   // Copy the new values.
-  v->_dictionary = [objects mutableCopy];
-  // Move the old values back to the main storage.
-  for (id key in oldObjects) {
-    v->_dictionary[key] = oldObjects[key];
+  CKComponentContextStore store;
+  for (id key in objects) {
+    store = store.insert(key, objects[key]);
   }
-  return oldObjects;
+  // Move the old values back to the main storage.
+  state.store.forEach([&](id key, id value) {
+    store = store.insert(key, value);
+  });
+  setStore(state, std::move(store));
+  return oldSnapshot;
 }
 
-void CKComponentInitialValuesContext::cleanInitialValues(NSMutableDictionary<Class, id> *oldObjects) noexcept
+void CKComponentInitialValuesContext::cleanInitialValues(CKComponentContextSnapshot *oldSnapshot) noexcept
 {
-  CKComponentContextValue *const v = contextValue(NO);
-  if (!v) {
+  if (oldSnapshot == nil) {
     return;
   }
-  v->_dictionary = oldObjects;
-  clearContextValueIfEmpty(v);
+  CKComponentContextState &state = contextState;
+  state.store = oldSnapshot->_store;
+  state.snapshot = oldSnapshot;
+  clearContextStateIfEmpty(state);
 }
@@ -52,6 +52,9 @@ struct CKBuildComponentTreeParams {
 
   // The current coalescing mode.
   RCComponentCoalescingMode coalescingMode = RCComponentCoalescingModeRender;
+
+  // Whether the render component children of a component are built concurrently, each on a fork of the generation.
+  BOOL buildsChildrenConcurrently = NO;
 };
 
 #endif
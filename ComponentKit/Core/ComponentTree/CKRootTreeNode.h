@@ -24,8 +24,12 @@ class CKRootTreeNode {
 public:
   CKRootTreeNode();
 
+  /** Links the node to its parent: the node keeps the path of identifiers from its parent up to the root. */
   void registerNode(CKTreeNode *node, CKTreeNode *parent) noexcept;
-  /** Query the parent node of existing node*/
+  /**
+   Query the parent node of existing node.
+   This walks the tree looking for the node, so it is only meant for debugging.
+   */
   CKTreeNode *parentForNodeIdentifier(CKTreeNodeIdentifier nodeIdentifier) const;
 
   /** Returns whether the node has children or not */
@@ -46,11 +50,19 @@ public:
   /** Called after a render component generates its children */
   void didBuildComponentTree() noexcept;
 
+  /**
+   Merges the root of a fork of the scope root, in which a subtree of this generation was built on another thread.
+   The render components being built on this thread are marked as dirty if any was marked in the fork.
+   */
+  void mergeFork(const CKRootTreeNode &fork) noexcept;
+
 private:
   /** the root node of the component tree */
   CKTreeNode *_node;
-  /** A map between a tree node identifier to its parent node. */
+#if CK_ASSERTIONS_ENABLED
+  /** A map between a tree node identifier to its parent node, to diagnose nodes registered twice. */
   std::unordered_map<CKTreeNodeIdentifier, CKTreeNode *> _nodesToParentNodes;
+#endif
   /**
    A set of the dirty node ids, which will be used in the NEXT component generation during props updates.
    Dirty node id, in the context of props update means that a component cannot be reused with `shouldComponentUpdate: method.
@@ -66,20 +66,32 @@ void CKRootTreeNode::registerNode(CKTreeNode *node, CKTreeNode *parent) noexcept
                                   parentComponentTreeDescription);
       }
     }
-#endif
     _nodesToParentNodes[node.nodeIdentifier] = parent;
+#endif
+    node->_path = std::make_shared<const CKTreeNodePath>(CKTreeNodePath{node.nodeIdentifier, parent->_path});
   }
 }
 
-CKTreeNode *CKRootTreeNode::parentForNodeIdentifier(CKTreeNodeIdentifier nodeIdentifier) const {
-  RCCAssert(nodeIdentifier != 0, @"Cannot retrieve parent for an empty node");
-  auto const it = _nodesToParentNodes.find(nodeIdentifier);
-  if (it != _nodesToParentNodes.end()) {
-    return it->second;
+static CKTreeNode *parentOfNodeInSubtree(CKTreeNode *subtree, CKTreeNodeIdentifier nodeIdentifier) {
+  for (auto const &child : subtree->_children) {
+    if (child.key.type() != CKTreeNodeComponentKey::Type::parent) {
+      continue;
+    }
+    if (child.node.nodeIdentifier == nodeIdentifier) {
+      return subtree;
+    }
+    if (auto const parent = parentOfNodeInSubtree(child.node, nodeIdentifier)) {
+      return parent;
+    }
   }
   return nil;
 }
 
+CKTreeNode *CKRootTreeNode::parentForNodeIdentifier(CKTreeNodeIdentifier nodeIdentifier) const {
+  RCCAssert(nodeIdentifier != 0, @"Cannot retrieve parent for an empty node");
+  return parentOfNodeInSubtree(_node, nodeIdentifier);
+}
+
 bool CKRootTreeNode::isEmpty() const {
   return _node.childrenSize == 0;
 }
@@ -109,3 +121,15 @@ void CKRootTreeNode::didBuildComponentTree() noexcept {
     _stack.pop();
   }
 }
+
+void CKRootTreeNode::mergeFork(const CKRootTreeNode &fork) noexcept {
+#if CK_ASSERTIONS_ENABLED
+  // Existing entries win: the children of the forks are registered with their parent in this generation already.
+  _nodesToParentNodes.insert(fork._nodesToParentNodes.begin(), fork._nodesToParentNodes.end());
+#endif
+  if (!fork._dirtyNodeIdsForPropsUpdates.empty()) {
+    // The render components being built on this thread are ancestors of the ones built in the fork.
+    markTopRenderComponentAsDirtyForPropsUpdates();
+    _dirtyNodeIdsForPropsUpdates.insert(fork._dirtyNodeIdsForPropsUpdates.begin(), fork._dirtyNodeIdsForPropsUpdates.end());
+  }
+}
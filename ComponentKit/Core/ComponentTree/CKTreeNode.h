@@ -22,6 +22,10 @@
 
 #if CK_NOT_SWIFT
 
+#include <memory>
+
+struct CKTreeNodeChildIndex;
+
 namespace CK {
 namespace TreeNode {
   /**
@@ -38,6 +42,18 @@ struct CKComponentScopePair {
   CKTreeNode *previousNode;
 };
 
+/**
+ The identifiers of a tree node and of its ancestors, up to the root node.
+
+ A reused node is linked to a parent with the same identifier in every generation, so the path a node is linked with
+ never changes; it is shared by the children of the node, and outlives the nodes it describes.
+ */
+struct CKTreeNodePath {
+  CKTreeNodeIdentifier nodeIdentifier;
+  /** Null for the children of a root node. */
+  std::shared_ptr<const CKTreeNodePath> parent;
+};
+
 #endif
 
 /**
@@ -53,6 +69,10 @@ struct CKComponentScopePair {
   @package
   CKTreeNodeComponentKey _componentKey;
   std::vector<CKTreeNodeComponentKeyToNode> _children;
+  /** Hashed lookups into `_children`, built once the node has enough children. */
+  std::unique_ptr<CKTreeNodeChildIndex> _childIndex;
+  /** Set by CKRootTreeNode::registerNode; null for root nodes and for nodes that are not linked to a parent yet. */
+  std::shared_ptr<const CKTreeNodePath> _path;
 }
 
 - (instancetype)init NS_UNAVAILABLE;
@@ -88,17 +108,25 @@ struct CKComponentScopePair {
 
 @property (nonatomic, assign, readonly) CKTreeNodeIdentifier nodeIdentifier;
 
+/** The identifier of the parent the node is linked to, or 0 if it is linked to a root node or not linked yet. */
+@property (nonatomic, assign, readonly) CKTreeNodeIdentifier parentNodeIdentifier;
+
 /** Returns the component's state */
 @property (nonatomic, strong, readonly) id state;
 
 /** Returns the componeny key according to its current owner */
 @property (nonatomic, assign, readonly) const CKTreeNodeComponentKey &componentKey;
 
+/**
+ Layout state that the component keeps between generations, e.g. a retained Yoga tree.
+ It is carried over from the previous node, so it is shared by all the generations of the component.
+ */
+@property (atomic, strong) id retainedLayoutState;
+
 - (void)reusePreviousNode:(CKTreeNode *)node inScopeRoot:(CKComponentScopeRoot *)scopeRoot;
 
 /** This method should be called after a node has been reused */
-- (void)didReuseWithParent:(CKTreeNode *)parent
-               inScopeRoot:(CKComponentScopeRoot *)scopeRoot;
+- (void)didReuseInScopeRoot:(CKComponentScopeRoot *)scopeRoot;
 
 /** This method should be called on nodes that have been created from CKComponentScope */
 - (void)linkComponent:(id<CKComponentProtocol>)component
@@ -136,6 +164,16 @@ struct CKComponentScopePair {
 /** Save a child node in the parent node according to its component key; this method is being called once during the component tree creation */
 - (void)setChild:(CKTreeNode *)child forComponentKey:(const CKTreeNodeComponentKey &)componentKey;
 
+/**
+ Returns one fork of this node per component, to build the components on other threads. A fork stands in for this node
+ as the parent of its component: it keys it as this node would if the components were linked to it in order.
+ Call -mergeForks:inScopeRoot: once the components are built.
+ */
+- (std::vector<CKTreeNode *>)forksForChildComponents:(const std::vector<id<CKRenderComponentProtocol>> &)components;
+
+/** Links the children of the forks to this node, in order. */
+- (void)mergeForks:(const std::vector<CKTreeNode *> &)forks inScopeRoot:(CKComponentScopeRoot *)scopeRoot;
+
 #endif
 
 #if DEBUG
@@ -20,6 +20,7 @@
 
 #include <tuple>
 #include <atomic>
+#include <unordered_map>
 
 #import "CKThreadLocalComponentScope.h"
 #import "CKRenderHelpers.h"
@@ -53,6 +54,50 @@ namespace TreeNode {
 }
 }
 
+/** Below this number of children, scanning them is faster than maintaining an index. */
+static const size_t kMinChildrenForIndex = 8;
+
+/**
+ Indexes the children of a tree node by component key, and counts them by component type and identifier, so that wide
+ parents don't have to scan all of their children for every child they create or look up.
+ */
+struct CKTreeNodeChildIndex {
+  struct TypeAndIdentifier {
+    const char *componentTypeName;
+    id identifier;
+
+    bool operator==(const TypeAndIdentifier &other) const
+    {
+      return componentTypeName == other.componentTypeName && RCObjectIsEqual(identifier, other.identifier);
+    }
+  };
+
+  struct TypeAndIdentifierHash {
+    size_t operator()(const TypeAndIdentifier &t) const noexcept
+    {
+      return RCHash64ToNative(RCHashCombine((uintptr_t)t.componentTypeName, [t.identifier hash]));
+    }
+  };
+
+  struct ComponentKeyHash {
+    size_t operator()(const CKTreeNodeComponentKey &key) const noexcept
+    {
+      // The keys vector is left out; it is compared on collisions only.
+      return RCHash64ToNative(RCHashCombine(RCHashCombine((uintptr_t)key.componentTypeName, key.counter), [key.identifier hash]));
+    }
+  };
+
+  /** The number of children of each component type and identifier, which is what key counters are made of. */
+  std::unordered_map<TypeAndIdentifier, NSUInteger, TypeAndIdentifierHash> childCounts;
+  std::unordered_map<CKTreeNodeComponentKey, CKTreeNode *, ComponentKeyHash> nodes;
+
+  void add(const CKTreeNodeComponentKeyToNode &child)
+  {
+    childCounts[{child.key.componentTypeName, child.key.identifier}]++;
+    // Like the linear lookup, the first child with a given key wins.
+    nodes.emplace(child.key, child.node);
+  }
+};
 
 @interface CKTreeNode ()
 @property (nonatomic, weak, readwrite) id<CKComponentProtocol> component;
@@ -70,6 +115,7 @@ namespace TreeNode {
   if (self = [super init]) {
     _scopeHandle = scopeHandle;
     _nodeIdentifier = previousNode ? previousNode.nodeIdentifier : ++nextGlobalIdentifier;
+    _retainedLayoutState = previousNode.retainedLayoutState;
     _scopeHandle.treeNode = self;
   }
   return self;
@@ -158,6 +204,11 @@ namespace TreeNode {
   return _scopeHandle.state;
 }
 
+- (CKTreeNodeIdentifier)parentNodeIdentifier
+{
+  return _path && _path->parent ? _path->parent->nodeIdentifier : 0;
+}
+
 - (const CKTreeNodeComponentKey &)componentKey
 {
   return _componentKey;
@@ -166,18 +217,23 @@ namespace TreeNode {
 - (void)reusePreviousNode:(CKTreeNode *)node inScopeRoot:(CKComponentScopeRoot *)scopeRoot
 {
   // Transfer the children vector from the reused node.
+  // The children keep the path they were linked with, as this node has the same identifier as the reused one.
    _children = node->_children;
+  _childIndex = node->_childIndex ? std::make_unique<CKTreeNodeChildIndex>(*node->_childIndex) : nullptr;
 
+  // The reused components only have to be registered for the predicates of the new scope root.
+  if (!scopeRoot.hasPredicates) {
+    return;
+  }
   for (auto const &child : _children) {
     if (child.key.type() == CKTreeNodeComponentKey::Type::parent) {
-      [child.node didReuseWithParent:self inScopeRoot:scopeRoot];
+      [child.node didReuseInScopeRoot:scopeRoot];
     }
   }
 }
 
 
-- (void)didReuseWithParent:(CKTreeNode *)parent
-               inScopeRoot:(CKComponentScopeRoot *)scopeRoot
+- (void)didReuseInScopeRoot:(CKComponentScopeRoot *)scopeRoot
 {
   // In case that CKComponentScope was created, but not acquired from the component (for example: early nil return) ,
   // the component was never linked to the scope handle/tree node, hence, we should stop the recursion here.
@@ -185,8 +241,6 @@ namespace TreeNode {
     return;
   }
 
-  RCAssert(parent != nil, @"The parent cannot be nil; every node should have a valid parent.");
-  scopeRoot.rootNode.registerNode(self, parent);
   if (_scopeHandle) {
     // Register the reused comopnent in the new scope root.
     [scopeRoot registerComponent:_component];
@@ -199,7 +253,7 @@ namespace TreeNode {
 
   for (auto const &child : _children) {
     if (child.key.type() == CKTreeNodeComponentKey::Type::parent) {
-      [child.node didReuseWithParent:self inScopeRoot:scopeRoot];
+      [child.node didReuseInScopeRoot:scopeRoot];
     }
   }
 }
@@ -222,6 +276,10 @@ namespace TreeNode {
 
 - (CKTreeNode *)childForComponentKey:(const CKTreeNodeComponentKey &)key
 {
+  if (_childIndex) {
+    const auto it = _childIndex->nodes.find(key);
+    return it != _childIndex->nodes.end() ? it->second : nil;
+  }
   for (auto const &child : _children) {
     if (child.key == key) {
       return child.node;
@@ -236,9 +294,16 @@ namespace TreeNode {
                                                    type:(CKTreeNodeComponentKey::Type)type
 {
   NSUInteger keyCounter = CKTreeNodeComponentKey::startOffsetForType(type);
-  for (auto const &child : _children) {
-    if (child.key.componentTypeName == componentTypeName && RCObjectIsEqual(child.key.identifier, identifier)) {
-      keyCounter += 2;
+  if (_childIndex) {
+    const auto it = _childIndex->childCounts.find({componentTypeName, identifier});
+    if (it != _childIndex->childCounts.end()) {
+      keyCounter += 2 * it->second;
+    }
+  } else {
+    for (auto const &child : _children) {
+      if (child.key.componentTypeName == componentTypeName && RCObjectIsEqual(child.key.identifier, identifier)) {
+        keyCounter += 2;
+      }
     }
   }
 
@@ -248,6 +313,50 @@ namespace TreeNode {
 - (void)setChild:(CKTreeNode *)child forComponentKey:(const CKTreeNodeComponentKey &)componentKey
 {
   _children.push_back(CKTreeNodeComponentKeyToNode{.key = componentKey, .node = child});
+  if (_childIndex) {
+    _childIndex->add(_children.back());
+  } else if (_children.size() >= kMinChildrenForIndex) {
+    _childIndex = std::make_unique<CKTreeNodeChildIndex>();
+    for (auto const &c : _children) {
+      _childIndex->add(c);
+    }
+  }
+}
+
+- (std::vector<CKTreeNode *>)forksForChildComponents:(const std::vector<id<CKRenderComponentProtocol>> &)components
+{
+  // The number of children of each type and identifier once the preceding components are linked.
+  std::unordered_map<CKTreeNodeChildIndex::TypeAndIdentifier, NSUInteger, CKTreeNodeChildIndex::TypeAndIdentifierHash> childCounts;
+  if (_childIndex) {
+    childCounts = _childIndex->childCounts;
+  } else {
+    for (auto const &child : _children) {
+      childCounts[{child.key.componentTypeName, child.key.identifier}]++;
+    }
+  }
+
+  std::vector<CKTreeNode *> forks;
+  forks.reserve(components.size());
+  for (auto const component : components) {
+    const CKTreeNodeChildIndex::TypeAndIdentifier typeAndIdentifier{component.typeName, component.componentIdentifier};
+    CKTreeNode *const fork = [CKTreeNode rootNode];
+    // The fork stands in for this node, so the nodes built in it get the same ancestors.
+    fork->_path = _path;
+    fork->_childIndex = std::make_unique<CKTreeNodeChildIndex>();
+    fork->_childIndex->childCounts[typeAndIdentifier] = childCounts[typeAndIdentifier]++;
+    forks.push_back(fork);
+  }
+  return forks;
+}
+
+- (void)mergeForks:(const std::vector<CKTreeNode *> &)forks inScopeRoot:(CKComponentScopeRoot *)scopeRoot
+{
+  for (CKTreeNode *const fork : forks) {
+    for (auto const &child : fork->_children) {
+      [self setChild:child.node forComponentKey:child.key];
+      scopeRoot.rootNode.registerNode(child.node, self);
+    }
+  }
 }
 
 static CKComponentScopeHandle *_createScopeHandle(CKComponentScopeRoot *scopeRoot,
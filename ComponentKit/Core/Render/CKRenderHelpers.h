@@ -102,8 +102,7 @@ namespace CKRender {
   /**
    Mark all the dirty nodes, on a path from an existing node up to the root node in the passed CKTreeNodeDirtyIds set.
    */
-  auto markTreeNodeDirtyIdsFromNodeUntilRoot(CKTreeNodeIdentifier nodeIdentifier,
-                                             const CKRootTreeNode &previousRootNode,
+  auto markTreeNodeDirtyIdsFromNodeUntilRoot(CKTreeNode *node,
                                              CKTreeNodeDirtyIds &treeNodesDirtyIds) -> void;
 
   /**
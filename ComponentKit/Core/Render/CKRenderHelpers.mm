@@ -15,6 +15,7 @@
 #import <ComponentKit/CKComponentContextHelper.h>
 #import <ComponentKit/CKComponentInternal.h>
 #import <ComponentKit/CKComponentScopeRoot.h>
+#import <ComponentKit/CKGenerationToken.h>
 #import <ComponentKit/CKMutex.h>
 #import <ComponentKit/CKOptional.h>
 #import <ComponentKit/CKTreeNode.h>
@@ -143,6 +144,94 @@ namespace CKRenderInternal {
     return NO;
   }
 
+  /** Below this number of children, building them on other threads costs more than it saves. */
+  static const size_t kMinChildrenForConcurrentBuild = 4;
+
+  // A child built on another thread, with its own fork of the parent node and of the scope root.
+  struct ConcurrentChildBuild {
+    id<CKRenderComponentProtocol> component;
+    CKTreeNode *parent;
+    CKComponentScopeRoot *scopeRoot;
+    CKComponentContextSnapshot *context;
+    NSUInteger componentAllocations;
+  };
+
+  // Returns the children of the component if they are all render components that can be built concurrently.
+  static auto childrenToBuildConcurrently(id<CKComponentProtocol> component,
+                                          unsigned int numberOfChildren,
+                                          const CKBuildComponentTreeParams &params) -> std::vector<id<CKRenderComponentProtocol>> {
+    // Systrace events are nested per thread.
+    if (!params.buildsChildrenConcurrently ||
+        numberOfChildren < kMinChildrenForConcurrentBuild ||
+        params.systraceListener != nil ||
+        params.shouldCollectTreeNodeCreationInformation ||
+        CKThreadLocalComponentScope::currentScope() == nullptr) {
+      return {};
+    }
+    std::vector<id<CKRenderComponentProtocol>> children;
+    children.reserve(numberOfChildren);
+    for (unsigned int i = 0; i < numberOfChildren; i++) {
+      auto const child = (id<CKComponentProtocol>)[component childAtIndex:i];
+      if (child == nil) {
+        continue;
+      }
+      // Other components can link several nodes to the parent, which have to be keyed in order.
+      if (![(id)child isKindOfClass:[CKRenderComponent class]]) {
+        return {};
+      }
+      children.push_back((id<CKRenderComponentProtocol>)child);
+    }
+    if (children.size() < kMinChildrenForConcurrentBuild) {
+      return {};
+    }
+    return children;
+  }
+
+  // Builds the component trees of the children concurrently, then merges them into the parent node and scope root
+  // in order, as if they had been built one after the other.
+  static auto buildChildrenConcurrently(const std::vector<id<CKRenderComponentProtocol>> &children,
+                                        CKTreeNode *parent,
+                                        CKTreeNode *_Nullable previousParent,
+                                        const CKBuildComponentTreeParams &params,
+                                        BOOL parentHasStateUpdate) -> void {
+    auto const threadLocalScope = CKThreadLocalComponentScope::currentScope();
+    CKComponentScopeRoot *const scopeRoot = params.scopeRoot;
+    auto const parentForks = [parent forksForChildComponents:children];
+
+    std::vector<ConcurrentChildBuild> builds;
+    builds.reserve(children.size());
+    for (size_t i = 0; i < children.size(); i++) {
+      builds.push_back({
+        .component = children[i],
+        .parent = parentForks[i],
+        .scopeRoot = [scopeRoot newFork],
+        .context = CKComponentContextHelper::takeComponentTreeContext(children[i]),
+      });
+    }
+
+    ConcurrentChildBuild *const pendingBuilds = builds.data();
+    const CKBuildComponentTreeParams *const parentParams = &params;
+    CKGenerationToken *const generationToken = CKGenerationToken::current();
+    dispatch_apply(builds.size(), dispatch_get_global_queue(qos_class_self(), 0), ^(size_t i) {
+      ConcurrentChildBuild &build = pendingBuilds[i];
+      CKGenerationToken::Scope generationTokenScope(generationToken);
+      CKThreadLocalComponentScope forkedScope(*threadLocalScope, build.scopeRoot, {.node = build.parent, .previousNode = previousParent});
+      CKComponentContextHelper::setComponentTreeContext(build.component, build.context);
+      CKBuildComponentTreeParams forkParams = *parentParams;
+      forkParams.scopeRoot = build.scopeRoot;
+      [build.component buildComponentTree:build.parent
+                           previousParent:previousParent
+                                   params:forkParams
+                     parentHasStateUpdate:parentHasStateUpdate];
+      build.componentAllocations = forkedScope.componentAllocations;
+    });
+
+    [parent mergeForks:parentForks inScopeRoot:scopeRoot];
+    for (auto const &build : builds) {
+      [scopeRoot mergeFork:build.scopeRoot];
+      threadLocalScope->componentAllocations += build.componentAllocations;
+    }
+  }
 
 static auto didBuildComponentTree(CKTreeNode *node,
                                   id<CKComponentProtocol> component,
@@ -172,6 +261,11 @@ namespace CKRender {
       RCCAssertNotNil(component, @"component cannot be nil");
       RCCAssertNotNil(parent, @"parent cannot be nil");
 
+      // A superseded generation is thrown away; stop building its tree.
+      if (CKGenerationToken::isCurrentCancelled()) {
+        return;
+      }
+
       // Check if the component already has a tree node.
       CKTreeNode *node = component.treeNode;
 
@@ -214,6 +308,12 @@ namespace CKRender {
         }
       }
 
+      auto const concurrentChildren = CKRenderInternal::childrenToBuildConcurrently(component, numberOfChildren, params);
+      if (!concurrentChildren.empty()) {
+        CKRenderInternal::buildChildrenConcurrently(concurrentChildren, parent, previousParent, params, parentHasStateUpdate);
+        return;
+      }
+
       for (int i=0; i<numberOfChildren; i++) {
         auto const childComponent = (id<CKComponentProtocol>)[component childAtIndex:i];
         if (childComponent) {
@@ -283,6 +383,12 @@ namespace CKRender {
         // Systrace logging
         [params.systraceListener willBuildComponent:component.typeName];
 
+        // A superseded generation is thrown away; stop rendering its components.
+        if (CKGenerationToken::isCurrentCancelled()) {
+          CKRenderInternal::didBuildComponentTree(node, component, params);
+          return node;
+        }
+
         // Faster state/props optimizations require previous parent.
         if (CKRenderInternal::reusePreviousComponentForSingleChild(node, component, childComponent, parent, previousParent, params, parentHasStateUpdate, didReuseBlock)) {
           CKRenderInternal::didBuildComponentTree(node, component, params);
@@ -372,21 +478,20 @@ namespace CKRender {
     return NO;
   }
 
-  auto markTreeNodeDirtyIdsFromNodeUntilRoot(CKTreeNodeIdentifier nodeIdentifier,
-                                             const CKRootTreeNode &previousRootNode,
+  auto markTreeNodeDirtyIdsFromNodeUntilRoot(CKTreeNode *node,
                                              CKTreeNodeDirtyIds &treeNodesDirtyIds) -> void
   {
-    CKTreeNodeIdentifier currentNodeIdentifier = nodeIdentifier;
+    // Nodes that are not linked to a parent, like the ones of trees without render components, only mark themselves.
+    CKTreeNodeIdentifier currentNodeIdentifier = node.nodeIdentifier;
+    const CKTreeNodePath *parentPath = node->_path ? node->_path->parent.get() : nullptr;
     while (currentNodeIdentifier != 0) {
       auto const insertPair = treeNodesDirtyIds.insert(currentNodeIdentifier);
       // If we got to a node that is already in the set, we can stop as the path to the root is already dirty.
       if (insertPair.second == false) {
         break;
       }
-      auto const parentNode = previousRootNode.parentForNodeIdentifier(currentNodeIdentifier);
-      RCCAssert((parentNode || nodeIdentifier == currentNodeIdentifier),
-                @"The next parent cannot be nil unless it's a root component.");
-      currentNodeIdentifier = parentNode.nodeIdentifier;
+      currentNodeIdentifier = parentPath ? parentPath->nodeIdentifier : 0;
+      parentPath = parentPath ? parentPath->parent.get() : nullptr;
     }
   }
 
@@ -399,7 +504,11 @@ namespace CKRender {
     // Compute the dirtyNodeIds in case of a state update only.
     if (buildTrigger == CKBuildTriggerStateUpdate) {
       for (auto const & stateUpdate : stateUpdates) {
-        CKRender::markTreeNodeDirtyIdsFromNodeUntilRoot(stateUpdate.first.treeNodeIdentifier, previousRoot.rootNode, treeNodesDirtyIds);
+        // The node of a scope handle is only gone if the handle is not part of the previous generation, in which case
+        // its state update can't be applied.
+        if (auto const treeNode = stateUpdate.first.treeNode) {
+          CKRender::markTreeNodeDirtyIdsFromNodeUntilRoot(treeNode, treeNodesDirtyIds);
+        }
       }
     }
     return treeNodesDirtyIds;
@@ -15,6 +15,7 @@
 #import <Foundation/Foundation.h>
 
 #import <unordered_set>
+#import <vector>
 
 #import <ComponentKit/CKCollection.h>
 #import <ComponentKit/CKComponentBoundsAnimation.h>
@@ -66,12 +67,25 @@ struct CKStateUpdateMetadata;
 /** Creates a new version of an existing scope root, ready to be used for building a component tree */
 - (instancetype)newRoot;
 
+/**
+ Creates a scope root that stands in for this one while a subtree of its component tree is built on another thread.
+ Its components, controllers and nodes are registered in this scope root by -mergeFork:.
+ */
+- (instancetype)newFork;
+
+/** Registers what was registered in a fork, in the same order, as if it had been registered here. */
+- (void)mergeFork:(CKComponentScopeRoot *)fork;
+
 /** Must be called when initializing a component or controller. */
 - (void)registerComponentController:(id<CKComponentControllerProtocol>)componentController;
 - (void)registerComponent:(id<CKComponentProtocol>)component;
 
-- (CKCocoaCollectionAdapter<id<CKComponentProtocol>>)componentsMatchingPredicate:(CKComponentPredicate)predicate;
-- (CKCocoaCollectionAdapter<id<CKComponentControllerProtocol>>)componentControllersMatchingPredicate:(CKComponentControllerPredicate)predicate;
+/** The components and controllers of this generation that matched a predicate, in registration order. */
+- (const std::vector<id<CKComponentProtocol>> &)componentsMatchingPredicate:(CKComponentPredicate)predicate;
+- (const std::vector<id<CKComponentControllerProtocol>> &)componentControllersMatchingPredicate:(CKComponentControllerPredicate)predicate;
+
+/** Whether the scope root was initialized with any predicate, so that registering components or controllers matters. */
+@property (nonatomic, readonly) BOOL hasPredicates;
 
 @property (nonatomic, weak, readonly) id<CKComponentStateListener> listener;
 @property (nonatomic, strong, readonly) id<CKAnalyticsListener> analyticsListener;
@@ -92,4 +106,13 @@ struct CKStateUpdateMetadata;
 
 @end
 
+/**
+ Declares that a predicate only depends on the class of the component or controller it is given. Scope roots created
+ afterwards evaluate it once per class and reuse the result for every instance of that class.
+
+ At most 64 predicates can be declared class-pure; further declarations are ignored.
+ */
+void CKComponentPredicateDeclareClassPure(CKComponentPredicate predicate);
+void CKComponentControllerPredicateDeclareClassPure(CKComponentControllerPredicate predicate);
+
 #endif
@@ -11,24 +11,155 @@
 #import "CKComponentScopeRoot.h"
 
 #include <atomic>
+#include <unordered_map>
 
 #import <ComponentKit/CKInternalHelpers.h>
+#import <ComponentKit/CKMutex.h>
 #import <ComponentKit/CKRootTreeNode.h>
 
 #import "CKComponentProtocol.h"
 #import "CKComponentControllerProtocol.h"
 #import "CKThreadLocalComponentScope.h"
 
-typedef std::unordered_map<CKComponentPredicate, NSHashTable<id<CKComponentProtocol>> *> _CKRegisteredComponentsMap;
-typedef std::unordered_map<CKComponentControllerPredicate, NSHashTable<id<CKComponentControllerProtocol>> *> _CKRegisteredComponentControllerMap;
+static constexpr int kMaxClassPurePredicates = 64;
+
+static CK::StaticMutex classPurePredicatesMutex = CK_MUTEX_INITIALIZER; // protects classPurePredicateBits()
+
+/** Class-pure predicates, keyed by function pointer, mapped to the bit of their result in the per-class cache. */
+static std::unordered_map<const void *, int> &classPurePredicateBits()
+{
+  static auto *bits = new std::unordered_map<const void *, int>();
+  return *bits;
+}
+
+static void declareClassPure(const void *predicate)
+{
+  CK::StaticMutexLocker l(classPurePredicatesMutex);
+  auto &bits = classPurePredicateBits();
+  if (bits.find(predicate) != bits.end()) {
+    return;
+  }
+  if ((int)bits.size() == kMaxClassPurePredicates) {
+    RCCFailAssert(@"Only %d predicates can be declared class-pure", kMaxClassPurePredicates);
+    return;
+  }
+  bits.emplace(predicate, (int)bits.size());
+}
+
+void CKComponentPredicateDeclareClassPure(CKComponentPredicate predicate)
+{
+  declareClassPure((const void *)predicate);
+}
+
+void CKComponentControllerPredicateDeclareClassPure(CKComponentControllerPredicate predicate)
+{
+  declareClassPure((const void *)predicate);
+}
+
+template <typename Predicate, typename T>
+struct CKPredicateMatches {
+  Predicate predicate;
+  /** The bit of the predicate in the per-class cache, or -1 when it has to be evaluated on every instance. */
+  int classResultBit;
+  /** Strong, so that registering a match doesn't go through the weak reference tables; released with the generation. */
+  std::vector<T> matches;
+};
+
+template <typename Predicate, typename T>
+static auto predicateMatchesFor(const std::unordered_set<Predicate> &predicates) -> std::vector<CKPredicateMatches<Predicate, T>>
+{
+  CK::StaticMutexLocker l(classPurePredicatesMutex);
+  const auto &bits = classPurePredicateBits();
+  std::vector<CKPredicateMatches<Predicate, T>> predicateMatches;
+  predicateMatches.reserve(predicates.size());
+  for (const auto &predicate : predicates) {
+    const auto it = bits.find((const void *)predicate);
+    predicateMatches.push_back({predicate, it != bits.end() ? it->second : -1, {}});
+  }
+  return predicateMatches;
+}
+
+/** The results of the class-pure predicates evaluated so far for one class, one bit per predicate. */
+struct CKClassPredicateResults {
+  uint64_t evaluated;
+  uint64_t matched;
+};
+
+/** Adds `object` to the matches of every predicate it satisfies, and returns whether it satisfied any. */
+template <typename PredicateMatches, typename T>
+static BOOL registerMatches(T object, std::vector<PredicateMatches> &predicateMatches)
+{
+  // Thread local so that concurrent generations don't contend on it; classes are never unloaded.
+  static thread_local std::unordered_map<Class, CKClassPredicateResults> classResults;
+  CKClassPredicateResults *results = nullptr;
+  BOOL matchedAny = NO;
+  for (auto &entry : predicateMatches) {
+    BOOL matched;
+    if (entry.classResultBit < 0) {
+      matched = entry.predicate(object);
+    } else {
+      if (!results) {
+        results = &classResults[[object class]];
+      }
+      const uint64_t bit = 1ull << entry.classResultBit;
+      if ((results->evaluated & bit) == 0) {
+        results->evaluated |= bit;
+        if (entry.predicate(object)) {
+          results->matched |= bit;
+        }
+      }
+      matched = (results->matched & bit) != 0;
+    }
+    if (matched) {
+      entry.matches.push_back(object);
+      matchedAny = YES;
+    }
+  }
+  return matchedAny;
+}
+
+template <typename PredicateMatches>
+static auto matchesForPredicate(const std::vector<PredicateMatches> &predicateMatches,
+                                decltype(PredicateMatches::predicate) predicate) -> const decltype(PredicateMatches::matches) &
+{
+  for (const auto &entry : predicateMatches) {
+    if (entry.predicate == predicate) {
+      return entry.matches;
+    }
+  }
+  static const decltype(PredicateMatches::matches) noMatches;
+  return noMatches;
+}
+
+/** Appends the matches of a fork, except the objects registered already. */
+template <typename PredicateMatches>
+static void mergeMatches(std::vector<PredicateMatches> &predicateMatches,
+                         const std::vector<PredicateMatches> &forkPredicateMatches,
+                         const std::unordered_set<const void *> &registeredObjects)
+{
+  for (const auto &forkEntry : forkPredicateMatches) {
+    for (auto &entry : predicateMatches) {
+      if (entry.predicate != forkEntry.predicate) {
+        continue;
+      }
+      for (const auto &object : forkEntry.matches) {
+        if (registeredObjects.find((__bridge const void *)object) == registeredObjects.end()) {
+          entry.matches.push_back(object);
+        }
+      }
+    }
+  }
+}
 
 @implementation CKComponentScopeRoot
 {
   std::unordered_set<CKComponentPredicate> _componentPredicates;
   std::unordered_set<CKComponentControllerPredicate> _componentControllerPredicates;
 
-  _CKRegisteredComponentsMap _registeredComponents;
-  _CKRegisteredComponentControllerMap _registeredComponentControllers;
+  std::vector<CKPredicateMatches<CKComponentPredicate, id<CKComponentProtocol>>> _componentMatches;
+  std::vector<CKPredicateMatches<CKComponentControllerPredicate, id<CKComponentControllerProtocol>>> _componentControllerMatches;
+  /** The components and controllers that matched at least one predicate, to ignore double registrations. */
+  std::unordered_set<const void *> _registeredObjects;
 
   CKRootTreeNode _rootNode;
 }
@@ -57,6 +188,21 @@ typedef std::unordered_map<CKComponentControllerPredicate, NSHashTable<id<CKComp
                           componentControllerPredicates:_componentControllerPredicates];
 }
 
+- (instancetype)newFork
+{
+  return [self newRoot];
+}
+
+- (void)mergeFork:(CKComponentScopeRoot *)fork
+{
+  RCAssert(fork.globalIdentifier == _globalIdentifier, @"Not a fork of this scope root");
+  mergeMatches(_componentMatches, fork->_componentMatches, _registeredObjects);
+  mergeMatches(_componentControllerMatches, fork->_componentControllerMatches, _registeredObjects);
+  _registeredObjects.insert(fork->_registeredObjects.begin(), fork->_registeredObjects.end());
+  _rootNode.mergeFork(fork->_rootNode);
+  _hasRenderComponentInTree = _hasRenderComponentInTree || fork->_hasRenderComponentInTree;
+}
+
 - (instancetype)initWithListener:(id<CKComponentStateListener>)listener
                analyticsListener:(id<CKAnalyticsListener>)analyticsListener
                 globalIdentifier:(CKComponentScopeRootIdentifier)globalIdentifier
@@ -71,6 +217,8 @@ typedef std::unordered_map<CKComponentControllerPredicate, NSHashTable<id<CKComp
     _globalIdentifier = globalIdentifier;
     _componentPredicates = componentPredicates;
     _componentControllerPredicates = componentControllerPredicates;
+    _componentMatches = predicateMatchesFor<CKComponentPredicate, id<CKComponentProtocol>>(componentPredicates);
+    _componentControllerMatches = predicateMatchesFor<CKComponentControllerPredicate, id<CKComponentControllerProtocol>>(componentControllerPredicates);
     _isEmpty = isEmpty;
   }
   return self;
@@ -82,16 +230,12 @@ typedef std::unordered_map<CKComponentControllerPredicate, NSHashTable<id<CKComp
     // Handle this gracefully so we don't have a bunch of nils being passed to predicates.
     return;
   }
-  for (const auto &predicate : _componentPredicates) {
-    if (predicate(component)) {
-      auto hashTable = _registeredComponents[predicate];
-      if (!hashTable) {
-        hashTable = [NSHashTable weakObjectsHashTable];
-        _registeredComponents[predicate] = hashTable;
-      }
-      RCWarn([hashTable containsObject:component] == NO, @"Double registration of component %@", component.className);
-      [hashTable addObject:component];
-    }
+  if (_registeredObjects.find((__bridge const void *)component) != _registeredObjects.end()) {
+    RCWarn(NO, @"Double registration of component %@", component.className);
+    return;
+  }
+  if (registerMatches(component, _componentMatches)) {
+    _registeredObjects.insert((__bridge const void *)component);
   }
 }
 
@@ -101,17 +245,12 @@ typedef std::unordered_map<CKComponentControllerPredicate, NSHashTable<id<CKComp
     // As above, handle a nil component controller gracefully instead of passing through to predicate.
     return;
   }
-  for (const auto &predicate : _componentControllerPredicates) {
-    if (predicate(componentController)) {
-      auto hashTable = _registeredComponentControllers[predicate];
-      if (!hashTable) {
-        hashTable = [NSHashTable weakObjectsHashTable];
-        _registeredComponentControllers[predicate] = hashTable;
-      }
-
-      RCWarn([hashTable containsObject:componentController] == NO, @"Double registration of component controller %@", componentController.class);
-      [hashTable addObject:componentController];
-    }
+  if (_registeredObjects.find((__bridge const void *)componentController) != _registeredObjects.end()) {
+    RCWarn(NO, @"Double registration of component controller %@", componentController.class);
+    return;
+  }
+  if (registerMatches(componentController, _componentControllerMatches)) {
+    _registeredObjects.insert((__bridge const void *)componentController);
   }
 }
 
@@ -122,22 +261,15 @@ typedef std::unordered_map<CKComponentControllerPredicate, NSHashTable<id<CKComp
     RCFailAssert(@"Must be given a block to enumerate.");
     return;
   }
-  RCAssert(_componentPredicates.find(predicate) != _componentPredicates.end(), @"Scope root must be initialized with predicate to enumerate.");
-
-  const auto foundIter = _registeredComponents.find(predicate);
-  if (foundIter != _registeredComponents.end()) {
-    for (id<CKComponentProtocol> component in foundIter->second) {
-      block(component);
-    }
+  for (id<CKComponentProtocol> component : [self componentsMatchingPredicate:predicate]) {
+    block(component);
   }
 }
 
-- (CKCocoaCollectionAdapter<id<CKComponentProtocol>>)componentsMatchingPredicate:(CKComponentPredicate)predicate
+- (const std::vector<id<CKComponentProtocol>> &)componentsMatchingPredicate:(CKComponentPredicate)predicate
 {
-  RCCAssert(CK::Collection::contains(_componentPredicates, predicate), @"Scope root must be initialized with predicate to enumerate.");
-  const auto componentsIt = _registeredComponents.find(predicate);
-  const auto components = componentsIt != _registeredComponents.end() ? componentsIt->second : @[];
-  return CKCocoaCollectionAdapter<id<CKComponentProtocol>>(components);
+  RCAssert(_componentPredicates.find(predicate) != _componentPredicates.end(), @"Scope root must be initialized with predicate to enumerate.");
+  return matchesForPredicate(_componentMatches, predicate);
 }
 
 - (void)enumerateComponentControllersMatchingPredicate:(CKComponentControllerPredicate)predicate
@@ -147,22 +279,20 @@ typedef std::unordered_map<CKComponentControllerPredicate, NSHashTable<id<CKComp
     RCFailAssert(@"Must be given a block to enumerate.");
     return;
   }
-  RCAssert(_componentControllerPredicates.find(predicate) != _componentControllerPredicates.end(), @"Scope root must be initialized with predicate to enumerate.");
-
-  const auto foundIter = _registeredComponentControllers.find(predicate);
-  if (foundIter != _registeredComponentControllers.end()) {
-    for (id<CKComponentControllerProtocol> componentController in foundIter->second) {
-      block(componentController);
-    }
+  for (id<CKComponentControllerProtocol> componentController : [self componentControllersMatchingPredicate:predicate]) {
+    block(componentController);
   }
 }
 
-- (CKCocoaCollectionAdapter<id<CKComponentControllerProtocol>>)componentControllersMatchingPredicate:(CKComponentControllerPredicate)predicate
+- (const std::vector<id<CKComponentControllerProtocol>> &)componentControllersMatchingPredicate:(CKComponentControllerPredicate)predicate
 {
   RCAssert(_componentControllerPredicates.find(predicate) != _componentControllerPredicates.end(), @"Scope root must be initialized with predicate to enumerate.");
-  const auto componentControllersIt = _registeredComponentControllers.find(predicate);
-  const auto componentControllers = componentControllersIt != _registeredComponentControllers.end() ? componentControllersIt->second : @[];
-  return CKCocoaCollectionAdapter<id<CKComponentControllerProtocol>>(componentControllers);
+  return matchesForPredicate(_componentControllerMatches, predicate);
+}
+
+- (BOOL)hasPredicates
+{
+  return !_componentPredicates.empty() || !_componentControllerPredicates.empty();
 }
 
 - (CKRootTreeNode &)rootNode
@@ -13,9 +13,24 @@
 #import "CKComponentControllerEvents.h"
 #import "CKComponentEvents.h"
 
+/** The default predicates only look at which methods the class of a component or controller overrides. */
+static void declareDefaultPredicatesClassPure()
+{
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    CKComponentPredicateDeclareClassPure(&CKComponentBoundsAnimationPredicate);
+    CKComponentPredicateDeclareClassPure(&CKComponentDidPrepareLayoutForComponentToControllerPredicate);
+    CKComponentControllerPredicateDeclareClassPure(&CKComponentControllerInitializeEventPredicate);
+    CKComponentControllerPredicateDeclareClassPure(&CKComponentControllerAppearanceEventPredicate);
+    CKComponentControllerPredicateDeclareClassPure(&CKComponentControllerDisappearanceEventPredicate);
+    CKComponentControllerPredicateDeclareClassPure(&CKComponentControllerInvalidateEventPredicate);
+  });
+}
+
 CK::NonNull<CKComponentScopeRoot *> CKComponentScopeRootWithDefaultPredicates(id<CKComponentStateListener> stateListener,
                                                                               id<CKAnalyticsListener> analyticsListener)
 {
+  declareDefaultPredicatesClassPure();
   return CK::makeNonNull([CKComponentScopeRoot
           rootWithListener:stateListener
           analyticsListener:analyticsListener
@@ -36,6 +51,7 @@ CK::NonNull<CKComponentScopeRoot *> CKComponentScopeRootWithPredicates(id<CKComp
                                                                        const std::unordered_set<CKComponentPredicate> &componentPredicates,
                                                                        const std::unordered_set<CKComponentControllerPredicate> &componentControllerPredicates)
 {
+  declareDefaultPredicatesClassPure();
   std::unordered_set<CKComponentPredicate> componentPredicatesUnion = {
     &CKComponentBoundsAnimationPredicate,
     &CKComponentDidPrepareLayoutForComponentToControllerPredicate
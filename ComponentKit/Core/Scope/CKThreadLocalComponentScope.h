@@ -37,6 +37,15 @@ public:
                               RCComponentCoalescingMode coalescingMode = RCComponentCoalescingModeNone,
                               BOOL enforceCKComponentSubclasses = YES,
                               BOOL disableRenderToNilInCoalescedCompositeComponents = NO);
+  /**
+   Forks the scope of the thread building a generation, to build a subtree of it on the current thread.
+   @param scope The scope of the thread building the generation.
+   @param scopeRoot A fork of the new scope root of `scope`, see -[CKComponentScopeRoot newFork].
+   @param pair The nodes the subtree is built under.
+   */
+  CKThreadLocalComponentScope(const CKThreadLocalComponentScope &scope,
+                              CKComponentScopeRoot *scopeRoot,
+                              CKComponentScopePair pair);
   ~CKThreadLocalComponentScope();
 
   /** Returns nullptr if there isn't a current scope */
@@ -64,6 +64,29 @@ CKThreadLocalComponentScope::CKThreadLocalComponentScope(CKComponentScopeRoot *p
   pthread_setspecific(_threadKey(), this);
 }
 
+CKThreadLocalComponentScope::CKThreadLocalComponentScope(const CKThreadLocalComponentScope &scope,
+                                                         CKComponentScopeRoot *scopeRoot,
+                                                         CKComponentScopePair pair)
+: newScopeRoot(scopeRoot),
+  previousScopeRoot(scope.previousScopeRoot),
+  stateUpdates(scope.stateUpdates),
+  stack(),
+  systraceListener(scope.systraceListener),
+  buildTrigger(scope.buildTrigger),
+  componentAllocations(0),
+  treeNodeDirtyIds(scope.treeNodeDirtyIds),
+  shouldCollectTreeNodeCreationInformation(scope.shouldCollectTreeNodeCreationInformation),
+  coalescingMode(scope.coalescingMode),
+  disableRenderToNilInCoalescedCompositeComponents(scope.disableRenderToNilInCoalescedCompositeComponents),
+  enforceCKComponentSubclasses(scope.enforceCKComponentSubclasses),
+  previousScope(CKThreadLocalComponentScope::currentScope())
+{
+  stack.push(std::move(pair));
+  keys.push({});
+  ancestorHasStateUpdate.push(NO);
+  pthread_setspecific(_threadKey(), this);
+}
+
 CKThreadLocalComponentScope::~CKThreadLocalComponentScope()
 {
   stack.pop();
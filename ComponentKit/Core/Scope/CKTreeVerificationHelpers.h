@@ -17,6 +17,7 @@
 struct RCLayout;
 
 @class CKComponentScopeRoot;
+@class CKTreeNode;
 @protocol CKMountable;
 
 /** Represents an info for a component that is being used more than once in a component tree */
@@ -47,4 +48,12 @@ CKDuplicateComponentInfo CKFindDuplicateComponent(const RCLayout &layout);
  */
 void CKVerifyTreeNodesToParentLinks(CKComponentScopeRoot *scopeRoot, const RCLayout &layout);
 
+/**
+ Same check as CKVerifyTreeNodesToParentLinks, for a single component of the layout. Used by passes that already walk
+ the layout and don't want to walk it again.
+ @param parentNode The tree node returned by this function for the closest ancestor that has one.
+ @return The tree node to pass as `parentNode` for the children of `component`.
+ */
+CKTreeNode *CKVerifyTreeNodeToParentLink(CKComponentScopeRoot *scopeRoot, id<CKMountable> component, CKTreeNode *parentNode);
+
 #endif
@@ -83,39 +83,47 @@ void CKDetectDuplicateComponent(const RCLayout &layout) {
 }
 
 #if CK_ASSERTIONS_ENABLED
+static CKTreeNode *CKVerifyTreeNodeOfComponent(const CKRootTreeNode &rootNode, id<CKMountable> component, CKTreeNode *parentNode)
+{
+  if (![component isKindOfClass:[CKComponent class]]) {
+    return nil;
+  }
+
+  auto const c = (CKComponent *)component;
+  CKTreeNode *const treeNode = c.treeNode;
+  if (treeNode == nil) {
+    return nil;
+  }
+
+  if (treeNode->_path == nullptr) {
+    RCCFailAssertWithCategory(RCComponentCompactDescription(c),
+                              @"Missing link from node to its parent on the CKRootTreeNode; \n"
+                              @"make sure your component returns all its children on the RCIterable methods.\n"
+                              @"Component:%@\n"
+                              @"Parent component:%@",
+                              c,
+                              parentNode.component);
+  } else if (treeNode.parentNodeIdentifier != parentNode.nodeIdentifier) {
+    RCCFailAssertWithCategory(RCComponentCompactDescription(c),
+                              @"Incorrect link from node to its parent on the CKRootTreeNode; \n"
+                              @"make sure your component returns all its children on the RCIterable methods.\n"
+                              @"Component:%@\n"
+                              @"Parent component:%@\n"
+                              @"Registered parent component:%@",
+                              c,
+                              parentNode.component,
+                              rootNode.parentForNodeIdentifier(treeNode.nodeIdentifier).component);
+  }
+  return treeNode;
+}
+
 static void CKVerifyTreeNodeWithParent(const CKRootTreeNode &rootNode, const RCLayout &layout, CKTreeNode *parentNode)
 {
   if (layout.component == nil) {
     return;
   }
 
-  CKTreeNode *treeNode = nil;
-  if ([layout.component isKindOfClass:[CKComponent class]]) {
-    auto const c = (CKComponent *)layout.component;
-    if (c.treeNode) {
-      treeNode = c.treeNode;
-      auto const registeredParentNode = rootNode.parentForNodeIdentifier(treeNode.nodeIdentifier);
-      if (registeredParentNode == nil) {
-        RCCFailAssertWithCategory(RCComponentCompactDescription(c),
-                                  @"Missing link from node to its parent on the CKRootTreeNode; \n"
-                                  @"make sure your component returns all its children on the RCIterable methods.\n"
-                                  @"Component:%@\n"
-                                  @"Parent component:%@",
-                                  c,
-                                  parentNode.component);
-      } else if (registeredParentNode != parentNode) {
-        RCCFailAssertWithCategory(RCComponentCompactDescription(c),
-                                  @"Incorrect link from node to its parent on the CKRootTreeNode; \n"
-                                  @"make sure your component returns all its children on the RCIterable methods.\n"
-                                  @"Component:%@\n"
-                                  @"Parent component:%@\n"
-                                  @"Registered parent component:%@",
-                                  c,
-                                  parentNode.component,
-                                  registeredParentNode.component);
-      }
-    }
-  }
+  CKTreeNode *const treeNode = CKVerifyTreeNodeOfComponent(rootNode, layout.component, parentNode);
 
   // Continue the check on the children; if the component has no tree node, pass the previous one.
   if (layout.children) {
@@ -136,4 +144,14 @@ void CKVerifyTreeNodesToParentLinks(CKComponentScopeRoot *scopeRoot, const RCLay
   #endif
 }
 
+CKTreeNode *CKVerifyTreeNodeToParentLink(CKComponentScopeRoot *scopeRoot, id<CKMountable> component, CKTreeNode *parentNode)
+{
+  #if CK_ASSERTIONS_ENABLED
+  if (component != nil && scopeRoot.hasRenderComponentInTree) {
+    return CKVerifyTreeNodeOfComponent(scopeRoot.rootNode, component, parentNode) ?: parentNode;
+  }
+  #endif
+  return parentNode;
+}
+
 #pragma clang diagnostic pop
@@ -56,6 +56,7 @@ static auto nilProvider(id<NSObject>, id<NSObject>) -> CKComponent * { return ni
   BOOL _isSynchronouslyUpdatingComponent;
   BOOL _isMountingComponent;
   BOOL _allowTapPassthrough;
+  BOOL _laysOutAsynchronously;
 
   CK::Optional<CGSize> _initialSize;
 }
@@ -103,9 +104,11 @@ static auto nilProvider(id<NSObject>, id<NSObject>) -> CKComponent * { return ni
        .componentPredicates = componentPredicates,
        .componentControllerPredicates = componentControllerPredicates,
        .analyticsListener = analyticsListener,
+       .coalescesStateUpdatesUntilNextFrame = options.coalescesStateUpdatesUntilNextFrame,
      }];
 
     _allowTapPassthrough = options.allowTapPassthrough;
+    _laysOutAsynchronously = options.laysOutAsynchronously;
     _containerViewProvider =
     [[CKComponentHostingContainerViewProvider alloc]
      initWithFrame:CGRectZero
@@ -316,7 +319,12 @@ static auto nilProvider(id<NSObject>, id<NSObject>) -> CKComponent * { return ni
     // Sync trait collection in `componentGenerator` before building the next generation.
     [_componentGenerator updateTraitCollection:self.traitCollection];
     [_componentGenerator updateAccessibilityStatus:CK::Component::Accessibility::IsAccessibilityEnabled()];
-    [_componentGenerator generateComponentAsynchronously];
+    if (_laysOutAsynchronously) {
+      const CGSize size = self.bounds.size;
+      [_componentGenerator generateComponentAsynchronouslyWithLayoutSizeRange:{size, size}];
+    } else {
+      [_componentGenerator generateComponentAsynchronously];
+    }
   });
 }
 
@@ -380,6 +388,21 @@ static auto nilProvider(id<NSObject>, id<NSObject>) -> CKComponent * { return ni
   [_delegate componentHostingViewDidInvalidateSize:self];
 }
 
+- (void)componentGenerator:(CKComponentGenerator *)componentGenerator
+didAsynchronouslyGenerateComponentResult:(CKBuildComponentResult)result
+                rootLayout:(const CKComponentRootLayout &)rootLayout
+{
+  _scheduledAsynchronousComponentUpdate = NO;
+  [self _applyResult:result];
+  // The layout was computed for the bounds at the time the update was scheduled; if they changed since,
+  // `layoutSubviews` lays the component out again.
+  if (CGSizeEqualToSize(rootLayout.size(), self.bounds.size)) {
+    [self _applyRootLayout:rootLayout];
+  }
+  [self setNeedsLayout];
+  [_delegate componentHostingViewDidInvalidateSize:self];
+}
+
 - (void)componentGenerator:(CKComponentGenerator *)componentGenerator didReceiveComponentStateUpdateWithMode:(CKUpdateMode)mode
 {
   [self _setNeedsUpdateWithMode:mode];
@@ -34,6 +34,12 @@ struct CKComponentHostingViewOptions {
   /// A initial size that will be used for hosting view before first generation of component is created.
   /// Specifying a initial size enables the ability to handle the first model/context update asynchronously.
   CK::Optional<CGSize> initialSize;
+  /// If set to YES, the state updates received before the next display refresh are built in a single generation.
+  /// See `CKComponentGeneratorOptions.coalescesStateUpdatesUntilNextFrame`. Default NO.
+  BOOL coalescesStateUpdatesUntilNextFrame;
+  /// If set to YES, asynchronous updates also lay out the new component off the main thread for the current bounds.
+  /// The main thread lays it out again only if the bounds changed in the meantime. Default NO.
+  BOOL laysOutAsynchronously;
 };
 
 @interface CKComponentHostingView<__covariant ModelType: id<NSObject>, __covariant ContextType: id<NSObject>> () <CKComponentHostingViewProtocol, CKComponentHostingViewWithLifecycle>
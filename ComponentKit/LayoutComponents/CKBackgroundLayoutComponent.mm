@@ -14,6 +14,7 @@
 #import <ComponentKit/CKMacros.h>
 #import <ComponentKit/CKComponentInternal.h>
 #import <ComponentKit/CKComponentPerfScope.h>
+#import "CKComponent+Yoga.h"
 #import "CKComponentSubclass.h"
 
 @implementation CKBackgroundLayoutComponent
@@ -71,4 +72,59 @@
   };
 }
 
+#pragma mark - Yoga
+
+/**
+ The background layout joins the Yoga tree of its parent flexbox if its component does. The background is an absolutely
+ positioned node pinned to all edges, so that it gets the size of the component without taking part in the layout.
+ */
+- (BOOL)isYogaBasedLayout
+{
+  return [_component isYogaBasedLayout];
+}
+
+- (YGNodeRef)ygNode:(CKSizeRange)constrainedSize
+{
+  if (![self isYogaBasedLayout]) {
+    return [super ygNode:constrainedSize];
+  }
+  const YGNodeRef node = YGNodeNewWithConfig(ckYogaDefaultConfig());
+  const CGSize parentSize = ckYogaParentSize(constrainedSize);
+
+  const YGNodeRef componentNode = [_component ygNode:constrainedSize];
+  ckYogaApplyNodeSize(componentNode, [_component nodeSize], parentSize);
+  YGNodeStyleSetFlexGrow(componentNode, 1);
+  YGNodeStyleSetFlexShrink(componentNode, 1);
+  YGNodeInsertChild(node, componentNode, 0);
+
+  if (_background) {
+    const YGNodeRef backgroundNode = [_background isYogaBasedLayout] ? [_background ygNode:constrainedSize] : YGNodeNewWithConfig(ckYogaDefaultConfig());
+    // The background is laid out at the size of the component, whatever its own size.
+    ckYogaApplyNodeSize(backgroundNode, {}, parentSize);
+    YGNodeStyleSetPositionType(backgroundNode, YGPositionTypeAbsolute);
+    YGNodeStyleSetPosition(backgroundNode, YGEdgeTop, 0);
+    YGNodeStyleSetPosition(backgroundNode, YGEdgeLeft, 0);
+    YGNodeStyleSetPosition(backgroundNode, YGEdgeBottom, 0);
+    YGNodeStyleSetPosition(backgroundNode, YGEdgeRight, 0);
+    YGNodeInsertChild(node, backgroundNode, 1);
+  }
+  return node;
+}
+
+- (RCLayout)layoutFromYgNode:(YGNodeRef)layoutNode thatFits:(CKSizeRange)constrainedSize
+{
+  const CGSize size = constrainedSize.clamp({YGNodeLayoutGetWidth(layoutNode), YGNodeLayoutGetHeight(layoutNode)});
+  // Yoga based children free their node, which removes it from this one, so both are fetched first.
+  const YGNodeRef componentNode = YGNodeGetChild(layoutNode, 0);
+  const YGNodeRef backgroundNode = _background ? YGNodeGetChild(layoutNode, 1) : nullptr;
+  RCLayoutChild contents = ckYogaLayoutChild(_component, componentNode, size);
+  std::vector<RCLayoutChild> children;
+  if (_background) {
+    children.push_back(ckYogaLayoutChild(_background, backgroundNode, contents.layout.size));
+  }
+  children.push_back(std::move(contents));
+  YGNodeFreeRecursive(layoutNode);
+  return {self, size, std::move(children)};
+}
+
 @end
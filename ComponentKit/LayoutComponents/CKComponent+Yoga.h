@@ -22,6 +22,27 @@
 
 YGConfigRef _Nonnull ckYogaDefaultConfig();
 
+/** The point scale factor of ckYogaDefaultConfig(), which Yoga rounds layouts to. */
+CGFloat ckYogaPointScaleFactor();
+
+/**
+ The size to resolve percentages against in a node built for constrainedSize: the dimensions that are exact, undefined
+ otherwise.
+ */
+CGSize ckYogaParentSize(const CKSizeRange &constrainedSize);
+
+/**
+ Sets the size of the node of a component nested in the node of a layout component, resolving percentages against
+ parentSize. This replaces any size the component set on its own node in -ygNode:.
+ */
+void ckYogaApplyNodeSize(YGNodeRef _Nonnull node, const RCComponentSize &nodeSize, CGSize parentSize);
+
+/**
+ Returns the layout of a component nested in the node of a layout component, once Yoga has laid it out, positioned in
+ its parent node. Yoga based components lay out from their node, the others are laid out at the size of the node.
+ */
+RCLayoutChild ckYogaLayoutChild(CKComponent *_Nonnull component, YGNodeRef _Nonnull node, CGSize parentSize);
+
 /**
  A protocol that is used for the components that are powered by Yoga layout engine
  (https://github.com/facebook/yoga).
@@ -21,11 +21,57 @@ YGConfigRef ckYogaDefaultConfig()
   static dispatch_once_t onceToken;
   dispatch_once(&onceToken, ^{
     defaultConfig = YGConfigNew();
-    YGConfigSetPointScaleFactor(defaultConfig, [UIScreen mainScreen].scale);
+    YGConfigSetPointScaleFactor(defaultConfig, ckYogaPointScaleFactor());
   });
   return defaultConfig;
 }
 
+CGFloat ckYogaPointScaleFactor()
+{
+  static CGFloat scale;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    scale = [UIScreen mainScreen].scale;
+  });
+  return scale;
+}
+
+CGSize ckYogaParentSize(const CKSizeRange &constrainedSize)
+{
+  return {
+    constrainedSize.min.width == constrainedSize.max.width ? constrainedSize.min.width : kCKComponentParentDimensionUndefined,
+    constrainedSize.min.height == constrainedSize.max.height ? constrainedSize.min.height : kCKComponentParentDimensionUndefined,
+  };
+}
+
+static float ygValue(const RCRelativeDimension &dimension, CGFloat parentValue)
+{
+  const CGFloat value = dimension.resolve(YGUndefined, parentValue);
+  return isinf(value) ? YGUndefined : static_cast<float>(value);
+}
+
+void ckYogaApplyNodeSize(YGNodeRef node, const RCComponentSize &nodeSize, CGSize parentSize)
+{
+  YGNodeStyleSetWidth(node, ygValue(nodeSize.width, parentSize.width));
+  YGNodeStyleSetHeight(node, ygValue(nodeSize.height, parentSize.height));
+  YGNodeStyleSetMinWidth(node, ygValue(nodeSize.minWidth, parentSize.width));
+  YGNodeStyleSetMaxWidth(node, ygValue(nodeSize.maxWidth, parentSize.width));
+  YGNodeStyleSetMinHeight(node, ygValue(nodeSize.minHeight, parentSize.height));
+  YGNodeStyleSetMaxHeight(node, ygValue(nodeSize.maxHeight, parentSize.height));
+}
+
+RCLayoutChild ckYogaLayoutChild(CKComponent *component, YGNodeRef node, CGSize parentSize)
+{
+  const CGPoint position = {YGNodeLayoutGetLeft(node), YGNodeLayoutGetTop(node)};
+  const CGSize size = {YGNodeLayoutGetWidth(node), YGNodeLayoutGetHeight(node)};
+  const CKSizeRange sizeRange = {size, size};
+  RCLayout layout = [component isYogaBasedLayout]
+  ? [component layoutFromYgNode:node thatFits:sizeRange]
+  : CKComputeComponentLayout(component, sizeRange, parentSize);
+  layout.size = size;
+  return {position, std::move(layout)};
+}
+
 CK_LINKABLE(CKComponent_Yoga)
 @implementation CKComponent (Yoga)
 
@@ -271,6 +271,25 @@ struct CKFlexboxComponentStyle {
    If set to NO, will allocate a yoga node for every single child even it is backed by yoga as well
    */
   BOOL useDeepYogaTrees{NO};
+
+  /**
+   If set to YES and the component has a tree node, its Yoga tree is kept on the tree node between layout passes and
+   generations instead of being rebuilt every time. Only the nodes whose style, component or parent size changed are
+   marked dirty, so Yoga can reuse the layout of everything else.
+
+   Children are matched to retained nodes by index. Has no effect when useDeepYogaTrees is set.
+   */
+  BOOL useRetainedYogaTree{NO};
+
+  /**
+   If set to YES, the children whose measurement constraints are known before Yoga runs are measured concurrently on
+   the global queue matching the caller's QoS, before the Yoga layout is calculated. These are the children with a
+   fixed or percent width that don't flex in a row, and any child in a column whose width is exact.
+
+   Use it for wide containers of expensive children, such as text. Children of small containers are still measured one
+   at a time. Has no effect when useRetainedYogaTree is set.
+   */
+  BOOL measureChildrenConcurrently{NO};
 };
 
 struct CKFlexboxComponentChild {
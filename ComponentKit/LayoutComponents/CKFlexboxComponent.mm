@@ -10,6 +10,10 @@
 
 #import "CKFlexboxComponent.h"
 
+#import <array>
+#import <atomic>
+#import <memory>
+
 #import <ComponentKit/CKComponentPerfScope.h>
 #import <ComponentKit/CKExceptionInfoScopedValue.h>
 #import <ComponentKit/CKGlobalConfig.h>
@@ -29,6 +33,8 @@
 #import "CKComponentSubclass.h"
 #import "CKCompositeComponent.h"
 #import "CKThreadLocalComponentScope.h"
+#import "CKTreeNode.h"
+#import "ComponentLayoutContext.h"
 #import "CKComponentViewConfiguration_SwiftBridge+Internal.h"
 #import "RCComponentSize_SwiftBridge+Internal.h"
 #import "RCDimension_SwiftBridge+Internal.h"
@@ -38,24 +44,217 @@ const struct CKStackComponentLayoutExtraKeys CKStackComponentLayoutExtraKeys = {
 };
 
 /*
- This class contains information about cached layout for FlexboxComponent child
+ This struct contains information about cached layouts for FlexboxComponent child.
+ Yoga may measure a child several times with different modes during one calculation, so the last few measurements are
+ kept and the oldest one is replaced when they are all taken.
  */
-@interface CKFlexboxChildCachedLayout : NSObject
+struct CKFlexboxChildCachedLayout {
+  static constexpr size_t kMaxMeasurements = 4;
+
+  struct Measurement {
+    YGMeasureMode widthMode;
+    YGMeasureMode heightMode;
+    float width;
+    float height;
+    RCLayout layout;
+  };
 
-@property (nonatomic) CKComponent *component;
-@property (nonatomic) RCLayout componentLayout;
-@property (nonatomic) float width;
-@property (nonatomic) float height;
-@property (nonatomic) YGMeasureMode widthMode;
-@property (nonatomic) YGMeasureMode heightMode;
-@property (nonatomic) CGSize parentSize;
-@property (nonatomic) NSInteger zIndex;
+  CKComponent *component;
+  CGSize parentSize = CGSizeZero;
+  NSInteger zIndex = 0;
 
-@end
+  void reset(CKComponent *c, CGSize p)
+  {
+    component = c;
+    parentSize = p;
+    for (size_t i = 0; i < measurementCount; i++) {
+      measurements[i].layout = {};
+    }
+    measurementCount = 0;
+    lastMeasurement = 0;
+  }
+
+  /** Returns the layout of a measurement that can be used for the given constraints, or nullptr. */
+  const RCLayout *find(YGMeasureMode widthMode, float width, YGMeasureMode heightMode, float height) const;
+  const RCLayout &insert(YGMeasureMode widthMode, float width, YGMeasureMode heightMode, float height, RCLayout layout);
+
+  /** The layout of the most recent measurement, or an empty layout of the component if it was never measured. */
+  RCLayout lastLayout() const
+  {
+    return measurementCount > 0 ? measurements[lastMeasurement].layout : RCLayout {component, {0, 0}};
+  }
+
+private:
+  std::array<Measurement, kMaxMeasurements> measurements;
+  size_t measurementCount = 0;
+  size_t lastMeasurement = 0;
+};
+
+/*
+ Scratch storage for the child records of the flexbox layouts computed on a thread. It is reset, keeping its memory,
+ when the outermost flexbox layout on the thread finishes, which covers the nested layouts of deep Yoga trees.
+ */
+class CKFlexboxChildCachedLayoutArena {
+public:
+  static CKFlexboxChildCachedLayoutArena &current()
+  {
+    static thread_local CKFlexboxChildCachedLayoutArena arena;
+    return arena;
+  }
+
+  CKFlexboxChildCachedLayout *make(CKComponent *component, CGSize parentSize)
+  {
+    if (_count == _chunks.size() * kChunkSize) {
+      _chunks.push_back(std::make_unique<std::array<CKFlexboxChildCachedLayout, kChunkSize>>());
+    }
+    CKFlexboxChildCachedLayout *const cachedLayout = &(*_chunks[_count / kChunkSize])[_count % kChunkSize];
+    _count++;
+    cachedLayout->reset(component, parentSize);
+    return cachedLayout;
+  }
+
+  /** Scope of a flexbox layout calculation; the arena is reset at the end of the outermost one. */
+  class Scope {
+  public:
+    Scope() : _arena(current()) { _arena._depth++; }
+    ~Scope()
+    {
+      if (--_arena._depth == 0) {
+        _arena.reset();
+      }
+    }
+
+  private:
+    CKFlexboxChildCachedLayoutArena &_arena;
+  };
+
+private:
+  static constexpr size_t kChunkSize = 32;
+
+  void reset()
+  {
+    // Releases the components and layouts, but keeps the chunks for the next layout.
+    for (size_t i = 0; i < _count; i++) {
+      (*_chunks[i / kChunkSize])[i % kChunkSize].reset(nil, CGSizeZero);
+    }
+    _count = 0;
+  }
+
+  std::vector<std::unique_ptr<std::array<CKFlexboxChildCachedLayout, kChunkSize>>> _chunks;
+  size_t _count = 0;
+  size_t _depth = 0;
+};
+
+/** Like Yoga's YGFloatMax, returns the defined value if the other one is undefined. */
+static float ygFloatMax(const float a, const float b)
+{
+  if (!YGFloatIsUndefined(a) && !YGFloatIsUndefined(b)) {
+    return fmaxf(a, b);
+  }
+  return YGFloatIsUndefined(a) ? b : a;
+}
+
+/** The constraints of a stack on one axis, as Yoga derives them from the style set by applyConstrainedSize(). */
+struct CKFlexboxStackAxis {
+  YGMeasureMode mode;
+  /** The space available to the children, undefined if unbounded. */
+  float available;
+  float min;
+  float max;
+
+  CKFlexboxStackAxis(const CGFloat minSize, const CGFloat maxSize)
+  {
+    if (minSize == maxSize) {
+      mode = YGMeasureModeExactly;
+      available = static_cast<float>(minSize);
+      min = YGUndefined;
+      max = YGUndefined;
+    } else {
+      min = static_cast<float>(minSize);
+      max = static_cast<float>(maxSize);
+      mode = YGFloatIsUndefined(max) ? YGMeasureModeUndefined : YGMeasureModeAtMost;
+      available = YGFloatIsUndefined(max) ? YGUndefined : ygFloatMax(max, min);
+    }
+  }
+
+  /** Clamps a size of the stack to its constraints, like YGNodeBoundAxis. */
+  float bound(float value) const
+  {
+    if (!YGFloatIsUndefined(max) && max >= 0 && value > max) {
+      value = max;
+    } else if (!YGFloatIsUndefined(min) && min >= 0 && value < min) {
+      value = min;
+    }
+    return ygFloatMax(value, 0);
+  }
+};
+
+struct CKFlexboxStackChild {
+  CKFlexboxChildCachedLayout *cachedLayout;
+  YGAlign align;
+  /** Spacing along the main axis, which Yoga applies as margins. */
+  float leadingMargin;
+  float trailingMargin;
+  float mainSize;
+  float crossSize;
+  float mainPosition;
+  float crossPosition;
+};
 
 template class std::vector<CKFlexboxComponentChild>;
 
-@implementation CKFlexboxChildCachedLayout
+struct CKFlexboxRetainedChild {
+  YGNodeRef node;
+  std::unique_ptr<CKFlexboxChildCachedLayout> cachedLayout;
+  YGBaselineFunc baselineFunc;
+  YGNodeType nodeType;
+};
+
+/*
+ The Yoga tree of a flexbox component that is kept on its tree node between layout passes, see
+ CKFlexboxComponentStyle.useRetainedYogaTree. The tree owns the nodes and their contexts.
+ */
+@interface CKFlexboxRetainedYogaTree : NSObject
+
+/** Returns NO if the tree is already being laid out on another thread. */
+- (BOOL)tryAcquire;
+- (void)relinquish;
+
+@end
+
+@implementation CKFlexboxRetainedYogaTree {
+  @package
+  YGNodeRef _rootNode;
+  /** A detached node that styles are applied to before being copied to the retained nodes, so that only actual changes dirty them. */
+  YGNodeRef _styleNode;
+  std::vector<CKFlexboxRetainedChild> _children;
+  std::atomic<bool> _isAcquired;
+}
+
+- (instancetype)init
+{
+  if (self = [super init]) {
+    _rootNode = YGNodeNewWithConfig(ckYogaDefaultConfig());
+    _styleNode = YGNodeNewWithConfig(ckYogaDefaultConfig());
+  }
+  return self;
+}
+
+- (void)dealloc
+{
+  YGNodeFreeRecursive(_rootNode);
+  YGNodeFree(_styleNode);
+}
+
+- (BOOL)tryAcquire
+{
+  return !_isAcquired.exchange(true);
+}
+
+- (void)relinquish
+{
+  _isAcquired = false;
+}
 
 @end
 
@@ -185,6 +384,7 @@ template class std::vector<CKFlexboxComponentChild>;
 @implementation CKFlexboxComponent {
   CKFlexboxComponentStyle _style;
   std::vector<CKFlexboxComponentChild> _children;
+  BOOL _isPlainStack;
 }
 
 - (instancetype)initWithView:(const CKComponentViewConfiguration &)view
@@ -195,6 +395,9 @@ template class std::vector<CKFlexboxComponentChild>;
   CKComponentPerfScope perfScope(self.class);
   if (self = [super initWithView:view size:size]) {
     _style = style;
+    if (CKReadGlobalConfig().useDeepYogaTrees) {
+      _style.useDeepYogaTrees = YES;
+    }
     _children = std::move(children);
 #if CK_ASSERTIONS_ENABLED
     for (const auto &child : _children) {
@@ -205,6 +408,7 @@ template class std::vector<CKFlexboxComponentChild>;
       }
     }
 #endif
+    _isPlainStack = isPlainStack(_style, _children);
   }
   return self;
 }
@@ -285,13 +489,41 @@ static bool CKYogaNodeCanUseCachedMeasurement(const YGMeasureMode widthMode,
   return YGNodeCanUseCachedMeasurement(widthMode, convertFloatToYogaRepresentation(width), heightMode, convertFloatToYogaRepresentation(height), lastWidthMode, convertFloatToYogaRepresentation(lastWidth), lastHeightMode, convertFloatToYogaRepresentation(lastHeight), convertFloatToYogaRepresentation(lastComputedWidth), convertFloatToYogaRepresentation(lastComputedHeight), convertFloatToYogaRepresentation(marginRow), convertFloatToYogaRepresentation(marginColumn), config);
 }
 
+const RCLayout *CKFlexboxChildCachedLayout::find(YGMeasureMode widthMode, float width, YGMeasureMode heightMode, float height) const
+{
+  // Most recent first, as Yoga usually asks again for the measurement it just made.
+  for (size_t i = 0; i < measurementCount; i++) {
+    const auto &m = measurements[(lastMeasurement + kMaxMeasurements - i) % kMaxMeasurements];
+    if (CKYogaNodeCanUseCachedMeasurement(widthMode, width, heightMode, height, m.widthMode, m.width, m.heightMode, m.height, static_cast<float>(m.layout.size.width), static_cast<float>(m.layout.size.height), 0, 0, ckYogaDefaultConfig())) {
+      return &m.layout;
+    }
+  }
+  return nullptr;
+}
+
+const RCLayout &CKFlexboxChildCachedLayout::insert(YGMeasureMode widthMode, float width, YGMeasureMode heightMode, float height, RCLayout layout)
+{
+  lastMeasurement = measurementCount == 0 ? 0 : (lastMeasurement + 1) % kMaxMeasurements;
+  measurementCount = measurementCount < kMaxMeasurements ? measurementCount + 1 : kMaxMeasurements;
+  measurements[lastMeasurement] = {widthMode, heightMode, width, height, std::move(layout)};
+  return measurements[lastMeasurement].layout;
+}
+
 static YGSize measureYGComponent(YGNodeRef node,
                                   float width,
                                   YGMeasureMode widthMode,
                                   float height,
                                   YGMeasureMode heightMode)
 {
-  CKFlexboxChildCachedLayout *cachedLayout = (__bridge CKFlexboxChildCachedLayout *)YGNodeGetContext(node);
+  return measureChild(static_cast<CKFlexboxChildCachedLayout *>(YGNodeGetContext(node)), width, widthMode, height, heightMode);
+}
+
+static YGSize measureChild(CKFlexboxChildCachedLayout *cachedLayout,
+                           float width,
+                           YGMeasureMode widthMode,
+                           float height,
+                           YGMeasureMode heightMode)
+{
   const CGSize minSize = {
     .width = (widthMode == YGMeasureModeExactly) ? width : 0,
     .height = (heightMode == YGMeasureModeExactly) ? height : 0
@@ -304,16 +536,12 @@ static YGSize measureYGComponent(YGNodeRef node,
   // ComponentKit and Yoga handle caching between calculations
   // We don't have any guarantees about when and how this will be called,
   // so we just cache the results to try to reuse them during final layout
-  if (!CKYogaNodeCanUseCachedMeasurement(widthMode, width, heightMode, height, cachedLayout.widthMode, cachedLayout.width, cachedLayout.heightMode, cachedLayout.height, static_cast<float>(cachedLayout.componentLayout.size.width), static_cast<float>(cachedLayout.componentLayout.size.height), 0, 0, ckYogaDefaultConfig())) {
-    CKComponent *component = cachedLayout.component;
-    cachedLayout.componentLayout = CKComputeComponentLayout(component, convertCKSizeRangeToCKRepresentation(CKSizeRange(minSize, maxSize)), convertCGSizeToCKRepresentation(cachedLayout.parentSize));
-    cachedLayout.width = width;
-    cachedLayout.height = height;
-    cachedLayout.widthMode = widthMode;
-    cachedLayout.heightMode = heightMode;
+  const RCLayout *componentLayout = cachedLayout->find(widthMode, width, heightMode, height);
+  if (componentLayout == nullptr) {
+    componentLayout = &cachedLayout->insert(widthMode, width, heightMode, height, CKComputeComponentLayout(cachedLayout->component, convertCKSizeRangeToCKRepresentation(CKSizeRange(minSize, maxSize)), convertCGSizeToCKRepresentation(cachedLayout->parentSize)));
   }
-  const float componentLayoutWidth = static_cast<float>(cachedLayout.componentLayout.size.width);
-  const float componentLayoutHeight = static_cast<float>(cachedLayout.componentLayout.size.height);
+  const float componentLayoutWidth = static_cast<float>(componentLayout->size.width);
+  const float componentLayoutHeight = static_cast<float>(componentLayout->size.height);
 
   const float measuredWidth = convertFloatToYogaRepresentation(componentLayoutWidth);
   const float measuredHeight = convertFloatToYogaRepresentation(componentLayoutHeight);
@@ -322,10 +550,10 @@ static YGSize measureYGComponent(YGNodeRef node,
 
 static float computeBaseline(YGNodeRef node, const float width, const float height)
 {
-  CKFlexboxChildCachedLayout *const cachedLayout = getCKFlexboxChildCachedLayoutFromYogaNode(node, width, height);
-  if ([cachedLayout.componentLayout.extra objectForKey:kCKComponentLayoutExtraBaselineKey]) {
-    RCCAssert([[cachedLayout.componentLayout.extra objectForKey:kCKComponentLayoutExtraBaselineKey] isKindOfClass:[NSNumber class]], @"You must set a NSNumber for kCKComponentLayoutExtraBaselineKey");
-    return [[cachedLayout.componentLayout.extra objectForKey:kCKComponentLayoutExtraBaselineKey] floatValue];
+  const RCLayout &componentLayout = getComponentLayoutFromYogaNode(node, width, height);
+  if ([componentLayout.extra objectForKey:kCKComponentLayoutExtraBaselineKey]) {
+    RCCAssert([[componentLayout.extra objectForKey:kCKComponentLayoutExtraBaselineKey] isKindOfClass:[NSNumber class]], @"You must set a NSNumber for kCKComponentLayoutExtraBaselineKey");
+    return [[componentLayout.extra objectForKey:kCKComponentLayoutExtraBaselineKey] floatValue];
   }
 
   return height;
@@ -336,21 +564,15 @@ static float useHeightAsBaselineFunction(YGNodeRef node, const float width, cons
   return height;
 }
 
-static CKFlexboxChildCachedLayout* getCKFlexboxChildCachedLayoutFromYogaNode(YGNodeRef node, const float width, const float height)
+static const RCLayout &getComponentLayoutFromYogaNode(YGNodeRef node, const float width, const float height)
 {
-  CKFlexboxChildCachedLayout *const cachedLayout = (__bridge CKFlexboxChildCachedLayout *)YGNodeGetContext(node);
+  CKFlexboxChildCachedLayout *const cachedLayout = static_cast<CKFlexboxChildCachedLayout *>(YGNodeGetContext(node));
 
-  if (!CKYogaNodeCanUseCachedMeasurement(YGMeasureModeExactly, width, YGMeasureModeExactly, height, cachedLayout.widthMode, cachedLayout.width, cachedLayout.heightMode, cachedLayout.height, static_cast<float>(cachedLayout.componentLayout.size.width), static_cast<float>(cachedLayout.componentLayout.size.height), 0, 0, ckYogaDefaultConfig())) {
-    const CGSize fixedSize = {width, height};
-    const RCLayout componentLayout = CKComputeComponentLayout(cachedLayout.component, convertCKSizeRangeToCKRepresentation(CKSizeRange(fixedSize, fixedSize)), convertCGSizeToCKRepresentation(cachedLayout.parentSize));
-    cachedLayout.componentLayout = componentLayout;
-    cachedLayout.width = width;
-    cachedLayout.height = height;
-    cachedLayout.widthMode = YGMeasureModeExactly;
-    cachedLayout.heightMode = YGMeasureModeExactly;
+  if (const RCLayout *componentLayout = cachedLayout->find(YGMeasureModeExactly, width, YGMeasureModeExactly, height)) {
+    return *componentLayout;
   }
-
-  return cachedLayout;
+  const CGSize fixedSize = {width, height};
+  return cachedLayout->insert(YGMeasureModeExactly, width, YGMeasureModeExactly, height, CKComputeComponentLayout(cachedLayout->component, convertCKSizeRangeToCKRepresentation(CKSizeRange(fixedSize, fixedSize)), convertCGSizeToCKRepresentation(cachedLayout->parentSize)));
 }
 
 static YGDirection ygApplicationDirection()
@@ -511,7 +733,17 @@ static bool hasChildWithRelativePositioning(const CKFlexboxComponentChild &child
  */
 - (YGNodeRef)ygStackLayoutNode:(CKSizeRange)constrainedSize
 {
-  const YGNodeRef stackNode = YGNodeNewWithConfig(ckYogaDefaultConfig());
+  return [self ygStackLayoutNode:constrainedSize retainedTree:nil];
+}
+
+/*
+ When retainedTree is set, the nodes of the retained tree are reused and the styles are first applied to its detached
+ style node, then copied over with YGNodeCopyStyle, which only marks the node dirty if its style actually changed.
+ */
+- (YGNodeRef)ygStackLayoutNode:(CKSizeRange)constrainedSize retainedTree:(CKFlexboxRetainedYogaTree *)retainedTree
+{
+  const YGNodeRef stackNode = retainedTree ? retainedTree->_rootNode : YGNodeNewWithConfig(ckYogaDefaultConfig());
+  size_t retainedChildCount = 0;
   YGEdge spacingEdge = ygSpacingEdgeFromDirection(_style.direction);
   CGFloat savedSpacing = 0;
   // We need this to resolve RCRelativeDimension with percentage bases
@@ -540,59 +772,76 @@ static bool hasChildWithRelativePositioning(const CKFlexboxComponentChild &child
       continue;
     }
 
-    const YGNodeRef childNode = _style.useDeepYogaTrees ? [child.component ygNode:constrainedSize] : YGNodeNewWithConfig(ckYogaDefaultConfig());
-
-    // We add object only if there is actual used element
-    CKFlexboxChildCachedLayout *childLayout = [CKFlexboxChildCachedLayout new];
-    childLayout.component = child.component;
-    childLayout.componentLayout = {child.component, {0, 0}};
-    childLayout.widthMode = (YGMeasureMode) -1;
-    childLayout.heightMode = (YGMeasureMode) -1;
-    childLayout.parentSize = parentSize;
-    childLayout.zIndex = child.zIndex;
-    if (child.aspectRatio.isDefined()) {
-      YGNodeStyleSetAspectRatio(childNode, child.aspectRatio.aspectRatio());
+    YGNodeRef childNode;
+    // The node the style is applied to; this is the child node itself unless the tree is retained.
+    YGNodeRef styleNode;
+    CKFlexboxChildCachedLayout *childLayout;
+    if (retainedTree) {
+      childLayout = retainedChildLayout(retainedTree, retainedChildCount, child.component, parentSize, stackNode);
+      childNode = retainedTree->_children[retainedChildCount].node;
+      styleNode = retainedTree->_styleNode;
+      YGNodeReset(styleNode);
+    } else {
+      childNode = _style.useDeepYogaTrees ? [child.component ygNode:constrainedSize] : YGNodeNewWithConfig(ckYogaDefaultConfig());
+      styleNode = childNode;
+
+      // We add a record only if there is actual used element.
+      // It lives in the arena until the outermost flexbox layout on this thread has finished.
+      childLayout = CKFlexboxChildCachedLayoutArena::current().make(child.component, parentSize);
+      YGNodeSetContext(childNode, childLayout);
+      if (YGNodeGetChildCount(childNode) == 0) {
+        YGNodeSetMeasureFunc(childNode, measureYGComponent);
+      }
     }
-
-    // We pass the pointer ownership to context to release it later.
-    // We want cachedLayout to be alive until we've finished calculations
-    YGNodeSetContext(childNode, (__bridge_retained void *)childLayout);
-    if (YGNodeGetChildCount(childNode) == 0) {
-      YGNodeSetMeasureFunc(childNode, measureYGComponent);
+    childLayout->zIndex = child.zIndex;
+    if (child.aspectRatio.isDefined()) {
+      YGNodeStyleSetAspectRatio(styleNode, child.aspectRatio.aspectRatio());
     }
 
-    if (_style.alignItems == CKFlexboxAlignItemsBaseline && [childLayout.component usesCustomBaseline]) {
-      YGNodeSetBaselineFunc(childNode, computeBaseline);
+    YGBaselineFunc baselineFunc = nullptr;
+    if (_style.alignItems == CKFlexboxAlignItemsBaseline && [childLayout->component usesCustomBaseline]) {
+      baselineFunc = computeBaseline;
     } else if (child.useHeightAsBaseline) {
-      YGNodeSetBaselineFunc(childNode, useHeightAsBaselineFunction);
+      baselineFunc = useHeightAsBaselineFunction;
     }
+    // TODO: t18095186 Remove explicit opt-out when Yoga is going to move to opt-in for text rounding
+    const YGNodeType nodeType = child.useTextRounding ? YGNodeTypeText : YGNodeTypeDefault;
+    if (retainedTree) {
+      // Neither of these are part of the style, so changing them doesn't dirty the node by itself.
+      auto &retainedChild = retainedTree->_children[retainedChildCount];
+      if (retainedChild.baselineFunc != baselineFunc || retainedChild.nodeType != nodeType) {
+        retainedChild.baselineFunc = baselineFunc;
+        retainedChild.nodeType = nodeType;
+        YGNodeMarkDirty(childNode);
+      }
+    }
+    YGNodeSetBaselineFunc(childNode, baselineFunc);
+    YGNodeSetNodeType(childNode, nodeType);
 
     // We need to make sure we do not include CKCompositeComponent
     // size as node size, as it will always we equal to {} and
     // use its child size instead
     const auto nodeSize = [child.component nodeSize];
-    applySizeAttributes(childNode, child, nodeSize, parentWidth, parentHeight, setPercentOnChildNode(_style));
+    applySizeAttributes(styleNode, child, nodeSize, parentWidth, parentHeight, setPercentOnChildNode(_style));
 
-    YGNodeStyleSetFlexGrow(childNode, child.flexGrow);
-    YGNodeStyleSetFlexShrink(childNode, child.flexShrink);
-    YGNodeStyleSetAlignSelf(childNode, ygAlignFromChild(child));
-    YGNodeStyleSetFlexBasis(childNode, child.flexBasis.resolve(YGUndefined, parentMainDimension));
-    // TODO: t18095186 Remove explicit opt-out when Yoga is going to move to opt-in for text rounding
-    YGNodeSetNodeType(childNode, child.useTextRounding ? YGNodeTypeText : YGNodeTypeDefault);
+    YGNodeStyleSetFlexGrow(styleNode, child.flexGrow);
+    YGNodeStyleSetFlexShrink(styleNode, child.flexShrink);
+    YGNodeStyleSetAlignSelf(styleNode, ygAlignFromChild(child));
+    YGNodeStyleSetFlexBasis(styleNode, child.flexBasis.resolve(YGUndefined, parentMainDimension));
 
-    applyPositionToEdge(childNode, YGEdgeStart, child.position.start);
-    applyPositionToEdge(childNode, YGEdgeEnd, child.position.end);
-    applyPositionToEdge(childNode, YGEdgeTop, child.position.top);
-    applyPositionToEdge(childNode, YGEdgeBottom, child.position.bottom);
-    applyPositionToEdge(childNode, YGEdgeLeft, child.position.left);
-    applyPositionToEdge(childNode, YGEdgeRight, child.position.right);
+    applyPositionToEdge(styleNode, YGEdgeStart, child.position.start);
+    applyPositionToEdge(styleNode, YGEdgeEnd, child.position.end);
+    applyPositionToEdge(styleNode, YGEdgeTop, child.position.top);
+    applyPositionToEdge(styleNode, YGEdgeBottom, child.position.bottom);
+    applyPositionToEdge(styleNode, YGEdgeLeft, child.position.left);
+    applyPositionToEdge(styleNode, YGEdgeRight, child.position.right);
 
-    applyPaddingToEdge(childNode, YGEdgeTop, child.padding.top);
-    applyPaddingToEdge(childNode, YGEdgeBottom, child.padding.bottom);
-    applyPaddingToEdge(childNode, YGEdgeStart, child.padding.start);
-    applyPaddingToEdge(childNode, YGEdgeEnd, child.padding.end);
+    applyPaddingToEdge(styleNode, YGEdgeTop, child.padding.top);
+    applyPaddingToEdge(styleNode, YGEdgeBottom, child.padding.bottom);
+    applyPaddingToEdge(styleNode, YGEdgeStart, child.padding.start);
+    applyPaddingToEdge(styleNode, YGEdgeEnd, child.padding.end);
 
-    YGNodeStyleSetPositionType(childNode, (child.position.type == CKFlexboxPositionTypeAbsolute) ? YGPositionTypeAbsolute : YGPositionTypeRelative);
+    YGNodeStyleSetPositionType(styleNode, (child.position.type == CKFlexboxPositionTypeAbsolute) ? YGPositionTypeAbsolute : YGPositionTypeRelative);
 
     // TODO: In odrer to keep the the logic consistent, we are resetting all
     // the margins that were potentially set from the child's style in
@@ -613,52 +862,114 @@ static bool hasChildWithRelativePositioning(const CKFlexboxComponentChild &child
     if (child.position.type == CKFlexboxPositionTypeRelative) {
       if (iterator != firstRelativeChild) {
         // Children in the middle have margin = spacingBefore + spacingAfter of previous + spacing of parent
-        YGNodeStyleSetMargin(childNode, spacingEdge, convertFloatToYogaRepresentation(child.spacingBefore + _style.spacing + savedSpacing));
+        YGNodeStyleSetMargin(styleNode, spacingEdge, convertFloatToYogaRepresentation(child.spacingBefore + _style.spacing + savedSpacing));
       } else {
         // For the space between parent and first child we just use spacingBefore
-        YGNodeStyleSetMargin(childNode, spacingEdge, convertFloatToYogaRepresentation(child.spacingBefore));
+        YGNodeStyleSetMargin(styleNode, spacingEdge, convertFloatToYogaRepresentation(child.spacingBefore));
       }
     }
 
-    YGNodeInsertChild(stackNode, childNode, YGNodeGetChildCount(stackNode));
+    if (!retainedTree) {
+      YGNodeInsertChild(stackNode, childNode, YGNodeGetChildCount(stackNode));
+    }
 
     if (child.position.type == CKFlexboxPositionTypeRelative) {
       savedSpacing = child.spacingAfter;
       if (iterator == lastRelativeChild) {
         // For the space between parent and last child we use only spacingAfter
-        YGNodeStyleSetMargin(childNode, ygSpacingEdgeFromDirection(_style.direction, YES), convertFloatToYogaRepresentation(savedSpacing));
+        YGNodeStyleSetMargin(styleNode, ygSpacingEdgeFromDirection(_style.direction, YES), convertFloatToYogaRepresentation(savedSpacing));
       }
     }
 
     /** The margins will override any spacing we applied earlier */
-    applyMarginToEdge(childNode, YGEdgeTop, child.margin.top);
-    applyMarginToEdge(childNode, YGEdgeBottom, child.margin.bottom);
-    applyMarginToEdge(childNode, YGEdgeStart, child.margin.start);
-    applyMarginToEdge(childNode, YGEdgeEnd, child.margin.end);
-  }
-
-  YGNodeStyleSetDirection(stackNode, ygDirectionFromStackStyle(_style));
-  YGNodeStyleSetFlexDirection(stackNode, ygFlexDirectionFromStackStyle(_style));
-  YGNodeStyleSetJustifyContent(stackNode, ygJustifyFromStackStyle(_style));
-  YGNodeStyleSetAlignItems(stackNode, ygAlignItemsFromStackStyle(_style));
-  YGNodeStyleSetAlignContent(stackNode, ygAlignContentFromStackStyle(_style));
-  YGNodeStyleSetFlexWrap(stackNode, ygWrapFromStackStyle(_style));
+    applyMarginToEdge(styleNode, YGEdgeTop, child.margin.top);
+    applyMarginToEdge(styleNode, YGEdgeBottom, child.margin.bottom);
+    applyMarginToEdge(styleNode, YGEdgeStart, child.margin.start);
+    applyMarginToEdge(styleNode, YGEdgeEnd, child.margin.end);
+
+    if (retainedTree) {
+      YGNodeCopyStyle(childNode, styleNode);
+      retainedChildCount++;
+    }
+  }
+
+  YGNodeRef stackStyleNode = stackNode;
+  if (retainedTree) {
+    removeRetainedChildren(retainedTree, retainedChildCount);
+    stackStyleNode = retainedTree->_styleNode;
+    YGNodeReset(stackStyleNode);
+  }
+
+  YGNodeStyleSetDirection(stackStyleNode, ygDirectionFromStackStyle(_style));
+  YGNodeStyleSetFlexDirection(stackStyleNode, ygFlexDirectionFromStackStyle(_style));
+  YGNodeStyleSetJustifyContent(stackStyleNode, ygJustifyFromStackStyle(_style));
+  YGNodeStyleSetAlignItems(stackStyleNode, ygAlignItemsFromStackStyle(_style));
+  YGNodeStyleSetAlignContent(stackStyleNode, ygAlignContentFromStackStyle(_style));
+  YGNodeStyleSetFlexWrap(stackStyleNode, ygWrapFromStackStyle(_style));
   // TODO: t18095186 Remove explicit opt-out when Yoga is going to move to opt-in for text rounding
   YGNodeSetNodeType(stackNode, YGNodeTypeDefault);
 
-  applyPaddingToEdge(stackNode, YGEdgeTop, _style.padding.top);
-  applyPaddingToEdge(stackNode, YGEdgeBottom, _style.padding.bottom);
-  applyPaddingToEdge(stackNode, YGEdgeStart, _style.padding.start);
-  applyPaddingToEdge(stackNode, YGEdgeEnd, _style.padding.end);
+  applyPaddingToEdge(stackStyleNode, YGEdgeTop, _style.padding.top);
+  applyPaddingToEdge(stackStyleNode, YGEdgeBottom, _style.padding.bottom);
+  applyPaddingToEdge(stackStyleNode, YGEdgeStart, _style.padding.start);
+  applyPaddingToEdge(stackStyleNode, YGEdgeEnd, _style.padding.end);
+
+  applyBorderToEdge(stackStyleNode, YGEdgeTop, _style.border.top);
+  applyBorderToEdge(stackStyleNode, YGEdgeBottom, _style.border.bottom);
+  applyBorderToEdge(stackStyleNode, YGEdgeStart, _style.border.start);
+  applyBorderToEdge(stackStyleNode, YGEdgeEnd, _style.border.end);
 
-  applyBorderToEdge(stackNode, YGEdgeTop, _style.border.top);
-  applyBorderToEdge(stackNode, YGEdgeBottom, _style.border.bottom);
-  applyBorderToEdge(stackNode, YGEdgeStart, _style.border.start);
-  applyBorderToEdge(stackNode, YGEdgeEnd, _style.border.end);
+  if (retainedTree) {
+    applyConstrainedSize(stackStyleNode, constrainedSize);
+    YGNodeCopyStyle(stackNode, stackStyleNode);
+  }
 
   return stackNode;
 }
 
+/*
+ Returns the cached layout of the retained child node at `index`, creating the node if needed. The cached measurement is
+ kept, and the node is not dirtied, only if the child is still the same component laid out in the same parent size.
+ */
+static CKFlexboxChildCachedLayout *retainedChildLayout(CKFlexboxRetainedYogaTree *retainedTree,
+                                                       size_t index,
+                                                       CKComponent *component,
+                                                       CGSize parentSize,
+                                                       YGNodeRef stackNode)
+{
+  auto &children = retainedTree->_children;
+  if (index == children.size()) {
+    const YGNodeRef node = YGNodeNewWithConfig(ckYogaDefaultConfig());
+    auto cachedLayout = std::make_unique<CKFlexboxChildCachedLayout>();
+    YGNodeSetContext(node, cachedLayout.get());
+    YGNodeSetMeasureFunc(node, measureYGComponent);
+    YGNodeInsertChild(stackNode, node, (uint32_t)index);
+    children.push_back({node, std::move(cachedLayout), nullptr, YGNodeTypeDefault});
+  } else {
+    CKFlexboxChildCachedLayout *const cachedLayout = children[index].cachedLayout.get();
+    if (cachedLayout->component == component && CGSizeEqualToSize(cachedLayout->parentSize, parentSize)) {
+      return cachedLayout;
+    }
+    YGNodeMarkDirty(children[index].node);
+  }
+
+  CKFlexboxChildCachedLayout *const cachedLayout = children[index].cachedLayout.get();
+  cachedLayout->reset(component, parentSize);
+  return cachedLayout;
+}
+
+/** Removes the retained child nodes from `count` on, for children that were removed since the previous layout. */
+static void removeRetainedChildren(CKFlexboxRetainedYogaTree *retainedTree, size_t count)
+{
+  auto &children = retainedTree->_children;
+  while (children.size() > count) {
+    const YGNodeRef node = children.back().node;
+    YGNodeRemoveChild(retainedTree->_rootNode, node);
+    YGNodeFree(node);
+    children.pop_back();
+  }
+}
+
 static void applySizeAttribute(YGNodeRef node,
                                void(*percentFunc)(YGNodeRef, float),
                                void(*pointFunc)(YGNodeRef, float),
@@ -782,19 +1093,70 @@ static void applyBorderToEdge(YGNodeRef node, YGEdge edge, CKFlexboxBorderDimens
 
 - (RCLayout)computeLayoutThatFits:(CKSizeRange)constrainedSize
 {
+  if (CKReadGlobalConfig().enableFlexboxStackLayout && [self canUseStackLayoutThatFits:constrainedSize]) {
+    return [self computeStackLayoutThatFits:constrainedSize];
+  }
+  return [self computeYogaLayoutThatFits:constrainedSize];
+}
+
+- (RCLayout)computeYogaLayoutThatFits:(CKSizeRange)constrainedSize
+{
+  const CKFlexboxChildCachedLayoutArena::Scope arenaScope;
   const CKSizeRange sanitizedSizeRange = convertCKSizeRangeToYogaRepresentation(constrainedSize);
+  CKFlexboxRetainedYogaTree *const retainedTree = [self acquireRetainedYogaTree];
+  if (retainedTree != nil) {
+    const YGNodeRef layoutNode = [self ygStackLayoutNode:sanitizedSizeRange retainedTree:retainedTree];
+    YGNodeCalculateLayout(layoutNode, YGUndefined, YGUndefined, YGDirectionLTR);
+    const RCLayout layout = [self layoutFromYgNode:layoutNode thatFits:constrainedSize ownsNodes:NO];
+    [retainedTree relinquish];
+    return layout;
+  }
+
   // We create cache for the duration of single calculation, so it is used only on one thread
   // The cache is strictly internal and shouldn't be exposed in any way
   // The purpose of the cache is to save calculations done in measure() function in Yoga to reuse
   // for final layout
   YGNodeRef layoutNode = [self ygNode:sanitizedSizeRange];
+  if (_style.measureChildrenConcurrently) {
+    measureChildrenConcurrently(_style, _children, layoutNode, sanitizedSizeRange);
+  }
 
   YGNodeCalculateLayout(layoutNode, YGUndefined, YGUndefined, YGDirectionLTR);
 
   return [self layoutFromYgNode:layoutNode thatFits:constrainedSize];
 }
 
+/*
+ Returns the retained Yoga tree of this component, creating it if needed, or nil if the tree should not or cannot be
+ retained. The tree must be relinquished once the layout has been computed.
+ */
+- (CKFlexboxRetainedYogaTree *)acquireRetainedYogaTree
+{
+  if (!_style.useRetainedYogaTree || _style.useDeepYogaTrees) {
+    return nil;
+  }
+  CKTreeNode *const treeNode = self.treeNode;
+  if (treeNode == nil) {
+    return nil;
+  }
+  CKFlexboxRetainedYogaTree *retainedTree = treeNode.retainedLayoutState;
+  if (![retainedTree isKindOfClass:[CKFlexboxRetainedYogaTree class]]) {
+    retainedTree = [CKFlexboxRetainedYogaTree new];
+    treeNode.retainedLayoutState = retainedTree;
+  }
+  // If another thread is laying out the same tree, we fall back to a temporary one.
+  return [retainedTree tryAcquire] ? retainedTree : nil;
+}
+
 - (RCLayout)layoutFromYgNode:(YGNodeRef)layoutNode thatFits:(CKSizeRange)constrainedSize
+{
+  return [self layoutFromYgNode:layoutNode thatFits:constrainedSize ownsNodes:YES];
+}
+
+/*
+ If ownsNodes is NO, the nodes belong to a retained tree and are not freed.
+ */
+- (RCLayout)layoutFromYgNode:(YGNodeRef)layoutNode thatFits:(CKSizeRange)constrainedSize ownsNodes:(BOOL)ownsNodes
 {
   // Before we finalize layout we want to sort children according to their z-order
   // We want children with higher z-order to be closer to the end of list
@@ -806,9 +1168,9 @@ static void applyBorderToEdge(YGNodeRef node, YGEdge edge, CKFlexboxBorderDimens
   }
   std::sort(sortedChildNodes.begin(), sortedChildNodes.end(),
             [] (YGNodeRef const& a, YGNodeRef const& b) {
-              CKFlexboxChildCachedLayout *aCachedContext = (__bridge CKFlexboxChildCachedLayout *)YGNodeGetContext(a);
-              CKFlexboxChildCachedLayout *bCachedContext = (__bridge CKFlexboxChildCachedLayout *)YGNodeGetContext(b);
-              return aCachedContext.zIndex < bCachedContext.zIndex;
+              const auto aCachedContext = static_cast<const CKFlexboxChildCachedLayout *>(YGNodeGetContext(a));
+              const auto bCachedContext = static_cast<const CKFlexboxChildCachedLayout *>(YGNodeGetContext(b));
+              return aCachedContext->zIndex < bCachedContext->zIndex;
             });
 
   std::vector<RCLayoutChild> childrenLayout(childCount);
@@ -822,48 +1184,59 @@ static void applyBorderToEdge(YGNodeRef node, YGEdge edge, CKFlexboxBorderDimens
     const CGFloat childY = convertFloatToCKRepresentation(YGNodeLayoutGetTop(childNode));
     const CGFloat childWidth = convertFloatToCKRepresentation(YGNodeLayoutGetWidth(childNode));
     const CGFloat childHeight = convertFloatToCKRepresentation(YGNodeLayoutGetHeight(childNode));
-    // Now we take back pointer ownership to be released, as we won't need it anymore
-    CKFlexboxChildCachedLayout *childCachedLayout = (__bridge_transfer CKFlexboxChildCachedLayout *)YGNodeGetContext(childNode);
+    CKFlexboxChildCachedLayout *const childCachedLayout = static_cast<CKFlexboxChildCachedLayout *>(YGNodeGetContext(childNode));
 
     childrenLayout[i].position = CGPointMake(childX, childY);
     const CGSize childSize = CGSizeMake(childWidth, childHeight);
     // We cache measurements for the duration of single layout calculation of FlexboxComponent
     // ComponentKit and Yoga handle caching between calculations
 
-    if (_style.useDeepYogaTrees && [childCachedLayout.component isYogaBasedLayout]) {
+    if (_style.useDeepYogaTrees && [childCachedLayout->component isYogaBasedLayout]) {
       // If the child component isYogaBasedLayout we don't call layoutThatFits:parentSize:
       // because it will create another Yoga tree. Instead, we call layoutFromYgNode:thatFits:
       // to reuse the already created yoga Node.
       const CKSizeRange childRange = {childSize, childSize};
       CKAssertSizeRange(childRange);
-      const CKSizeRange resolvedSizeRange = childCachedLayout.component.size.resolve(size);
+      const CKSizeRange resolvedSizeRange = childCachedLayout->component.size.resolve(size);
       CKAssertSizeRange(resolvedSizeRange);
       const CKSizeRange childConstraintSize = childRange.intersect(resolvedSizeRange);
       CKAssertSizeRange(childConstraintSize);
 
-      childrenLayout[i].layout = [childCachedLayout.component layoutFromYgNode:childNode thatFits:childConstraintSize];
-    } else if ([self canReuseCachedLayout:childCachedLayout forChildWithExactSize:childSize]) {
-      childrenLayout[i].layout = childCachedLayout.componentLayout;
+      childrenLayout[i].layout = [childCachedLayout->component layoutFromYgNode:childNode thatFits:childConstraintSize];
     } else {
-      const CKSizeRange childRange = {childSize, childSize};
-      CKAssertSizeRange(childRange);
-      childrenLayout[i].layout = CKComputeComponentLayout(childCachedLayout.component, childRange, size);
+      // Remember the final layout of a retained node so that it can be reused by the next pass if the node doesn't change.
+      childrenLayout[i].layout = finalChildLayout(childCachedLayout, childSize, size, !ownsNodes);
     }
     childrenLayout[i].layout.size = childSize;
   }
 
-  YGNodeFreeRecursive(layoutNode);
+  if (ownsNodes) {
+    YGNodeFreeRecursive(layoutNode);
+  }
 
   // width/height should already be within constrainedSize, but we're just clamping to correct for roundoff error
   return {self, constrainedSize.clamp(size), childrenLayout};
 }
 
-- (BOOL)canReuseCachedLayout:(const CKFlexboxChildCachedLayout * const)childCachedLayout
-       forChildWithExactSize:(const CGSize)childSize
+/*
+ Returns the layout of a child for its final size, reusing one of its measurements if possible.
+ If rememberLayout is set, a newly computed layout is added to the measurements of the child.
+ */
+static RCLayout finalChildLayout(CKFlexboxChildCachedLayout *cachedLayout, CGSize childSize, CGSize parentSize, BOOL rememberLayout)
 {
-  return CKYogaNodeCanUseCachedMeasurement(YGMeasureModeExactly, static_cast<float>(childSize.width), YGMeasureModeExactly, static_cast<float>(childSize.height), childCachedLayout.widthMode, childCachedLayout.width, childCachedLayout.heightMode, childCachedLayout.height, static_cast<float>(childCachedLayout.componentLayout.size.width), static_cast<float>(childCachedLayout.componentLayout.size.height), 0, 0, ckYogaDefaultConfig()) ||
-    childSize.width == 0 ||
-    childSize.height == 0;
+  if (const RCLayout *layout = cachedLayout->find(YGMeasureModeExactly, static_cast<float>(childSize.width), YGMeasureModeExactly, static_cast<float>(childSize.height))) {
+    return *layout;
+  }
+  if (childSize.width == 0 || childSize.height == 0) {
+    return cachedLayout->lastLayout();
+  }
+  const CKSizeRange childRange = {childSize, childSize};
+  CKAssertSizeRange(childRange);
+  RCLayout layout = CKComputeComponentLayout(cachedLayout->component, childRange, parentSize);
+  if (rememberLayout) {
+    cachedLayout->insert(YGMeasureModeExactly, static_cast<float>(childSize.width), YGMeasureModeExactly, static_cast<float>(childSize.height), layout);
+  }
+  return layout;
 }
 
 - (BOOL)isYogaBasedLayout
@@ -874,7 +1247,12 @@ static void applyBorderToEdge(YGNodeRef node, YGEdge edge, CKFlexboxBorderDimens
 - (YGNodeRef)ygNode:(CKSizeRange)constrainedSize
 {
   const YGNodeRef node = [self ygStackLayoutNode:constrainedSize];
+  applyConstrainedSize(node, constrainedSize);
+  return node;
+}
 
+static void applyConstrainedSize(YGNodeRef node, const CKSizeRange &constrainedSize)
+{
   // At the moment Yoga does not optimise minWidth == maxWidth, so we want to do it here
   // ComponentKit and Yoga use different constants for +Inf, so we need to make sure the don't interfere
   if (constrainedSize.min.width == constrainedSize.max.width) {
@@ -890,7 +1268,427 @@ static void applyBorderToEdge(YGNodeRef node, YGEdge edge, CKFlexboxBorderDimens
     YGNodeStyleSetMinHeight(node, constrainedSize.min.height);
     YGNodeStyleSetMaxHeight(node, constrainedSize.max.height);
   }
-  return node;
+}
+
+#pragma mark - Stack layout
+
+/*
+ Plain stacks, whose children are laid out in a single line and are neither flexible, nor sized, nor offset by the
+ flexbox, are laid out without building a Yoga tree when CKGlobalConfig.enableFlexboxStackLayout is set.
+ -computeStackLayoutThatFits: performs the steps of Yoga's algorithm that apply to them, in the same order and with the
+ same float arithmetic, including the rounding to the pixel grid, so that the layout is the same as the one computed by
+ Yoga.
+ */
+static bool isAutoDimension(const RCRelativeDimension &dimension)
+{
+  return dimension.type() == RCRelativeDimension::Type::AUTO;
+}
+
+static bool isUndefinedSpacing(const CKFlexboxSpacing &spacing)
+{
+  return !spacing.top.isDefined() && !spacing.bottom.isDefined() && !spacing.start.isDefined() && !spacing.end.isDefined();
+}
+
+static bool isPlainStackChild(const CKFlexboxComponentChild &child)
+{
+  if (child.component == nil) {
+    return true;
+  }
+  // Negative spacing is left to Yoga, as it takes other paths when the children don't fill any space.
+  return child.spacingBefore >= 0
+  && child.spacingAfter >= 0
+  && child.flexGrow == 0
+  && child.flexShrink == 0
+  && isAutoDimension(child.flexBasis)
+  && child.alignSelf != CKFlexboxAlignSelfBaseline
+  && child.position.type == CKFlexboxPositionTypeRelative
+  && isAutoDimension(child.position.start)
+  && isAutoDimension(child.position.top)
+  && isAutoDimension(child.position.end)
+  && isAutoDimension(child.position.bottom)
+  && isAutoDimension(child.position.left)
+  && isAutoDimension(child.position.right)
+  && isUndefinedSpacing(child.margin)
+  && isUndefinedSpacing(child.padding)
+  && !child.aspectRatio.isDefined()
+  && child.sizeConstraints == RCComponentSize()
+  && [child.component nodeSize] == RCComponentSize()
+  && !child.useTextRounding;
+}
+
+static bool isPlainStack(const CKFlexboxComponentStyle &style, const std::vector<CKFlexboxComponentChild> &children)
+{
+  if ((style.direction != CKFlexboxDirectionRow && style.direction != CKFlexboxDirectionColumn)
+      || style.wrap != CKFlexboxWrapNoWrap
+      || style.alignItems == CKFlexboxAlignItemsBaseline
+      || !(style.spacing >= 0)
+      || !isUndefinedSpacing(style.padding)
+      || style.border.top.isDefined() || style.border.bottom.isDefined() || style.border.start.isDefined() || style.border.end.isDefined()
+      || style.useDeepYogaTrees
+      || style.useRetainedYogaTree
+      || style.measureChildrenConcurrently) {
+    return false;
+  }
+  bool hasChild = false;
+  for (const auto &child : children) {
+    if (!isPlainStackChild(child)) {
+      return false;
+    }
+    hasChild = hasChild || child.component != nil;
+  }
+  return hasChild;
+}
+
+static float stackMargin(const CGFloat spacing)
+{
+  const float margin = convertFloatToYogaRepresentation(spacing);
+  return YGFloatIsUndefined(margin) ? 0 : margin;
+}
+
+/*
+ Measures a child like Yoga measures a node with a measure function: the margins are taken out of the available space,
+ and the component is not measured at all if the size is exact on both axes.
+ */
+static void measureStackChild(CKFlexboxStackChild &child,
+                              BOOL isRow,
+                              const float availableMain,
+                              const YGMeasureMode mainMode,
+                              const float availableCross,
+                              const YGMeasureMode crossMode)
+{
+  const float margin = child.leadingMargin + child.trailingMargin;
+  if (mainMode == YGMeasureModeExactly && crossMode == YGMeasureModeExactly) {
+    child.mainSize = ygFloatMax(availableMain - margin, 0);
+    child.crossSize = ygFloatMax(availableCross, 0);
+    return;
+  }
+  const float innerMain = YGFloatIsUndefined(availableMain) ? availableMain : ygFloatMax(0, availableMain - margin);
+  const float innerCross = YGFloatIsUndefined(availableCross) ? availableCross : ygFloatMax(0, availableCross);
+  const YGSize size = isRow
+  ? measureChild(child.cachedLayout, innerMain, mainMode, innerCross, crossMode)
+  : measureChild(child.cachedLayout, innerCross, crossMode, innerMain, mainMode);
+  child.mainSize = ygFloatMax(mainMode == YGMeasureModeExactly ? availableMain - margin : (isRow ? size.width : size.height), 0);
+  child.crossSize = ygFloatMax(crossMode == YGMeasureModeExactly ? availableCross : (isRow ? size.height : size.width), 0);
+}
+
+/** Rounds an edge to the pixel grid like YGRoundToPixelGrid does for nodes that are not text. */
+static float roundToPixelGrid(const float value)
+{
+  return YGRoundValueToPixelGrid(value, static_cast<float>(ckYogaPointScaleFactor()), false, false);
+}
+
+- (BOOL)canUseStackLayoutThatFits:(CKSizeRange)constrainedSize
+{
+  if (!_isPlainStack || ygDirectionFromStackStyle(_style) != YGDirectionLTR) {
+    return NO;
+  }
+  switch (_style.justifyContent) {
+    case CKFlexboxJustifyContentStart:
+    case CKFlexboxJustifyContentCenter:
+    case CKFlexboxJustifyContentEnd:
+      return YES;
+    case CKFlexboxJustifyContentSpaceBetween:
+    case CKFlexboxJustifyContentSpaceAround:
+    case CKFlexboxJustifyContentSpaceEvenly: {
+      // Yoga counts the space after the last child in the size of the stack when its main size isn't exact.
+      const CKSizeRange sanitizedSizeRange = convertCKSizeRangeToYogaRepresentation(constrainedSize);
+      return isHorizontalFlexboxDirection(_style.direction)
+      ? sanitizedSizeRange.min.width == sanitizedSizeRange.max.width
+      : sanitizedSizeRange.min.height == sanitizedSizeRange.max.height;
+    }
+  }
+}
+
+- (RCLayout)computeStackLayoutThatFits:(CKSizeRange)constrainedSize
+{
+  const CKFlexboxChildCachedLayoutArena::Scope arenaScope;
+  const CKSizeRange sanitizedSizeRange = convertCKSizeRangeToYogaRepresentation(constrainedSize);
+  const BOOL isRow = isHorizontalFlexboxDirection(_style.direction);
+  const CKFlexboxStackAxis widthAxis(sanitizedSizeRange.min.width, sanitizedSizeRange.max.width);
+  const CKFlexboxStackAxis heightAxis(sanitizedSizeRange.min.height, sanitizedSizeRange.max.height);
+  const CKFlexboxStackAxis &mainAxis = isRow ? widthAxis : heightAxis;
+  const CKFlexboxStackAxis &crossAxis = isRow ? heightAxis : widthAxis;
+  // Same as in -ygStackLayoutNode:, to resolve the sizes of the children.
+  const CGFloat parentWidth = (sanitizedSizeRange.min.width == sanitizedSizeRange.max.width) ? sanitizedSizeRange.min.width : kCKComponentParentDimensionUndefined;
+  const CGFloat parentHeight = (sanitizedSizeRange.min.height == sanitizedSizeRange.max.height) ? sanitizedSizeRange.min.height : kCKComponentParentDimensionUndefined;
+  const CGSize parentSize = CGSizeMake(parentWidth, parentHeight);
+  const YGAlign alignItems = ygAlignItemsFromStackStyle(_style);
+
+  std::vector<CKFlexboxStackChild> children;
+  children.reserve(_children.size());
+  CGFloat savedSpacing = 0;
+  for (const auto &child : _children) {
+    if (!child.component) {
+      continue;
+    }
+    CKFlexboxChildCachedLayout *const cachedLayout = CKFlexboxChildCachedLayoutArena::current().make(child.component, parentSize);
+    cachedLayout->zIndex = child.zIndex;
+    const YGAlign alignSelf = ygAlignFromChild(child);
+    // Spacing emulation, see -ygStackLayoutNode:
+    const CGFloat spacingBefore = children.empty() ? child.spacingBefore : child.spacingBefore + _style.spacing + savedSpacing;
+    children.push_back({cachedLayout, alignSelf == YGAlignAuto ? alignItems : alignSelf, stackMargin(spacingBefore), 0, 0, 0, 0, 0});
+    savedSpacing = child.spacingAfter;
+  }
+  children.back().trailingMargin = stackMargin(savedSpacing);
+
+  // Flex basis: every child is measured in the available space, exactly on the cross axis if it's stretched to an exact size.
+  const BOOL isCrossSizeExact = crossAxis.mode == YGMeasureModeExactly;
+  const YGMeasureMode fittingMainMode = YGFloatIsUndefined(mainAxis.available) ? YGMeasureModeUndefined : YGMeasureModeAtMost;
+  const YGMeasureMode fittingCrossMode = YGFloatIsUndefined(crossAxis.available) ? YGMeasureModeUndefined : YGMeasureModeAtMost;
+  float consumedMainSize = 0;
+  for (auto &child : children) {
+    const YGMeasureMode crossMode = (child.align == YGAlignStretch && isCrossSizeExact) ? YGMeasureModeExactly : fittingCrossMode;
+    measureStackChild(child, isRow, mainAxis.available, fittingMainMode, crossAxis.available, crossMode);
+    consumedMainSize += child.mainSize + (child.leadingMargin + child.trailingMargin);
+  }
+
+  // The stack only has free space if the children don't reach its main size, or its min size if the main size isn't exact.
+  float availableMainSize = mainAxis.available;
+  bool sizeBasedOnContent = false;
+  if (mainAxis.mode != YGMeasureModeExactly) {
+    if (!YGFloatIsUndefined(mainAxis.min) && consumedMainSize < mainAxis.min) {
+      availableMainSize = mainAxis.min;
+    } else if (!YGFloatIsUndefined(mainAxis.max) && consumedMainSize > mainAxis.max) {
+      availableMainSize = mainAxis.max;
+    } else {
+      sizeBasedOnContent = true;
+    }
+  }
+  float remainingFreeSpace = (!sizeBasedOnContent && !YGFloatIsUndefined(availableMainSize)) ? availableMainSize - consumedMainSize : 0;
+
+  // Children keep their flex basis as main size and are measured again for it.
+  for (auto &child : children) {
+    const YGMeasureMode crossMode = (child.align == YGAlignStretch && isCrossSizeExact) ? YGMeasureModeExactly : fittingCrossMode;
+    measureStackChild(child, isRow, child.mainSize + (child.leadingMargin + child.trailingMargin), YGMeasureModeExactly, crossAxis.available, crossMode);
+  }
+
+  // Main axis justification
+  if (mainAxis.mode == YGMeasureModeAtMost && remainingFreeSpace > 0) {
+    remainingFreeSpace = YGFloatIsUndefined(mainAxis.min) ? 0 : ygFloatMax(0, mainAxis.min - (availableMainSize - remainingFreeSpace));
+  }
+  const auto childCount = static_cast<float>(children.size());
+  float leadingMainSize = 0;
+  float betweenMainSize = 0;
+  switch (_style.justifyContent) {
+    case CKFlexboxJustifyContentStart:
+      break;
+    case CKFlexboxJustifyContentCenter:
+      leadingMainSize = remainingFreeSpace / 2;
+      break;
+    case CKFlexboxJustifyContentEnd:
+      leadingMainSize = remainingFreeSpace;
+      break;
+    case CKFlexboxJustifyContentSpaceBetween:
+      betweenMainSize = children.size() > 1 ? ygFloatMax(remainingFreeSpace, 0) / (childCount - 1) : 0;
+      break;
+    case CKFlexboxJustifyContentSpaceEvenly:
+      betweenMainSize = remainingFreeSpace / (childCount + 1);
+      leadingMainSize = betweenMainSize;
+      break;
+    case CKFlexboxJustifyContentSpaceAround:
+      betweenMainSize = remainingFreeSpace / childCount;
+      leadingMainSize = betweenMainSize / 2;
+      break;
+  }
+  float mainSize = leadingMainSize;
+  float childrenCrossSize = 0;
+  for (auto &child : children) {
+    child.mainPosition = child.leadingMargin + mainSize;
+    mainSize += betweenMainSize + (child.mainSize + (child.leadingMargin + child.trailingMargin));
+    childrenCrossSize = ygFloatMax(childrenCrossSize, child.crossSize);
+  }
+  const float crossSize = isCrossSizeExact ? crossAxis.available : crossAxis.bound(childrenCrossSize);
+
+  // Cross axis alignment
+  for (auto &child : children) {
+    switch (child.align) {
+      case YGAlignStretch:
+        measureStackChild(child, isRow, child.mainSize + (child.leadingMargin + child.trailingMargin), YGMeasureModeExactly, crossSize, YGMeasureModeExactly);
+        child.crossPosition = 0;
+        break;
+      case YGAlignCenter:
+        child.crossPosition = (crossSize - child.crossSize) / 2;
+        break;
+      case YGAlignFlexEnd:
+        child.crossPosition = crossSize - child.crossSize;
+        break;
+      default:
+        child.crossPosition = 0;
+        break;
+    }
+  }
+
+  const float stackMainSize = mainAxis.bound(mainAxis.mode == YGMeasureModeExactly ? mainAxis.available : ygFloatMax(0, mainSize));
+  const float stackCrossSize = crossAxis.bound(crossSize);
+  const float width = convertFloatToCKRepresentation(roundToPixelGrid(isRow ? stackMainSize : stackCrossSize));
+  const float height = convertFloatToCKRepresentation(roundToPixelGrid(isRow ? stackCrossSize : stackMainSize));
+  const CGSize size = {width, height};
+
+  // Same order as in -layoutFromYgNode:thatFits:
+  std::vector<const CKFlexboxStackChild *> sortedChildren;
+  sortedChildren.reserve(children.size());
+  for (const auto &child : children) {
+    sortedChildren.push_back(&child);
+  }
+  std::sort(sortedChildren.begin(), sortedChildren.end(),
+            [] (const CKFlexboxStackChild *const& a, const CKFlexboxStackChild *const& b) {
+              return a->cachedLayout->zIndex < b->cachedLayout->zIndex;
+            });
+
+  std::vector<RCLayoutChild> childrenLayout(sortedChildren.size());
+  for (size_t i = 0; i < sortedChildren.size(); i++) {
+    const CKFlexboxStackChild &child = *sortedChildren[i];
+    const float left = isRow ? child.mainPosition : child.crossPosition;
+    const float top = isRow ? child.crossPosition : child.mainPosition;
+    const float roundedLeft = roundToPixelGrid(left);
+    const float roundedTop = roundToPixelGrid(top);
+    const float childWidth = roundToPixelGrid(left + (isRow ? child.mainSize : child.crossSize)) - roundedLeft;
+    const float childHeight = roundToPixelGrid(top + (isRow ? child.crossSize : child.mainSize)) - roundedTop;
+
+    childrenLayout[i].position = CGPointMake(convertFloatToCKRepresentation(roundedLeft), convertFloatToCKRepresentation(roundedTop));
+    const CGSize childSize = CGSizeMake(convertFloatToCKRepresentation(childWidth), convertFloatToCKRepresentation(childHeight));
+    childrenLayout[i].layout = finalChildLayout(child.cachedLayout, childSize, size, NO);
+    childrenLayout[i].layout.size = childSize;
+  }
+
+  return {self, constrainedSize.clamp(size), childrenLayout};
+}
+
+#pragma mark - Concurrent measurement
+
+/*
+ With CKFlexboxComponentStyle.measureChildrenConcurrently, the children whose measurement constraints can be predicted
+ are measured concurrently before YGNodeCalculateLayout, filling the cached layouts that measureChild looks up. A wrong
+ prediction only costs the measurement made ahead of time, as Yoga then measures the child again as usual.
+ */
+
+/** Below this number of children to measure ahead of time, the children are left to Yoga to measure one at a time. */
+static const size_t kMinChildCountForConcurrentMeasurement = 4;
+
+struct CKFlexboxPendingMeasurement {
+  CKFlexboxChildCachedLayout *cachedLayout;
+  YGMeasureMode widthMode;
+  float width;
+};
+
+/** The horizontal padding and border of the flexbox, or NaN if they depend on the size of the flexbox. */
+static float horizontalPaddingAndBorder(const CKFlexboxComponentStyle &style)
+{
+  float insets = 0;
+  for (const auto &padding : {style.padding.start, style.padding.end}) {
+    if (!padding.isDefined()) {
+      continue;
+    }
+    if (padding.dimension().type() != RCRelativeDimension::Type::POINTS) {
+      return NAN;
+    }
+    insets += convertFloatToYogaRepresentation(padding.dimension().value());
+  }
+  for (const auto &border : {style.border.start, style.border.end}) {
+    if (border.isDefined()) {
+      insets += convertFloatToYogaRepresentation(border.value());
+    }
+  }
+  return insets;
+}
+
+/**
+ Returns whether the width Yoga will measure `child` with is known before the layout is calculated, and sets it. The
+ height is left undefined, which Yoga accepts for any height it allows the child to take.
+ */
+static bool predictMeasuredWidth(const CKFlexboxComponentStyle &style,
+                                 const CKFlexboxComponentChild &child,
+                                 float parentWidth,
+                                 float innerWidth,
+                                 YGMeasureMode &widthMode,
+                                 float &width)
+{
+  const RCComponentSize nodeSize = [child.component nodeSize];
+  if (child.position.type != CKFlexboxPositionTypeRelative
+      || child.aspectRatio.isDefined()
+      || !isUndefinedSpacing(child.padding)
+      || !isAutoDimension(child.sizeConstraints.minWidth) || !isAutoDimension(child.sizeConstraints.maxWidth)
+      || !isAutoDimension(nodeSize.minWidth) || !isAutoDimension(nodeSize.maxWidth)) {
+    return false;
+  }
+  const bool isRow = isHorizontalFlexboxDirection(style.direction);
+  if (isRow && (child.flexGrow != 0 || child.flexShrink != 0 || !isAutoDimension(child.flexBasis))) {
+    return false;
+  }
+
+  const bool usesNodeWidth = isAutoDimension(child.sizeConstraints.width);
+  const RCRelativeDimension childWidth = usesNodeWidth ? nodeSize.width : child.sizeConstraints.width;
+  switch (childWidth.type()) {
+    case RCRelativeDimension::Type::POINTS:
+      widthMode = YGMeasureModeExactly;
+      width = convertFloatToYogaRepresentation(childWidth.value());
+      return true;
+    case RCRelativeDimension::Type::PERCENT: {
+      // Percentages of the node size are resolved against the parent size unless they are set on the child node.
+      const float base = (usesNodeWidth && !setPercentOnChildNode(style)) ? parentWidth : innerWidth;
+      if (YGFloatIsUndefined(base)) {
+        return false;
+      }
+      widthMode = YGMeasureModeExactly;
+      width = base * static_cast<float>(childWidth.value());
+      return true;
+    }
+    case RCRelativeDimension::Type::AUTO: {
+      // In a column, children take the inner width of the flexbox when stretched, or at most that width otherwise.
+      if (isRow || YGFloatIsUndefined(innerWidth) || child.margin.start.isDefined() || child.margin.end.isDefined()) {
+        return false;
+      }
+      const bool stretches = child.alignSelf == CKFlexboxAlignSelfStretch
+      || (child.alignSelf == CKFlexboxAlignSelfAuto && style.alignItems == CKFlexboxAlignItemsStretch);
+      widthMode = stretches ? YGMeasureModeExactly : YGMeasureModeAtMost;
+      width = innerWidth;
+      return true;
+    }
+  }
+}
+
+static void measureChildrenConcurrently(const CKFlexboxComponentStyle &style,
+                                        const std::vector<CKFlexboxComponentChild> &children,
+                                        YGNodeRef stackNode,
+                                        const CKSizeRange &constrainedSize)
+{
+  const float parentWidth = constrainedSize.min.width == constrainedSize.max.width
+  ? static_cast<float>(constrainedSize.min.width)
+  : YGUndefined;
+  const float innerWidth = parentWidth - horizontalPaddingAndBorder(style);
+
+  std::vector<CKFlexboxPendingMeasurement> measurements;
+  uint32_t childIndex = 0;
+  for (const auto &child : children) {
+    if (!child.component) {
+      continue;
+    }
+    const YGNodeRef childNode = YGNodeGetChild(stackNode, childIndex++);
+    YGMeasureMode widthMode;
+    float width;
+    // Children with nodes of their own in deep Yoga trees are not measured through measureChild.
+    if (YGNodeHasMeasureFunc(childNode) && predictMeasuredWidth(style, child, parentWidth, innerWidth, widthMode, width)) {
+      measurements.push_back({static_cast<CKFlexboxChildCachedLayout *>(YGNodeGetContext(childNode)), widthMode, width});
+    }
+  }
+  if (measurements.size() < kMinChildCountForConcurrentMeasurement) {
+    return;
+  }
+
+  // The layout context is per thread, so the systrace listener is passed on to the threads measuring the children.
+  const auto &layoutStack = CK::Component::LayoutContext::currentStack();
+  id<CKSystraceListener> systraceListener = layoutStack.empty() ? nil : layoutStack.back()->systraceListener;
+  // The layout cache is per thread as well, so each child is measured with a cache of its own, merged afterwards.
+  const RCConcurrentLayoutCaches layoutCaches(measurements.size());
+  const RCConcurrentLayoutCaches *const layoutCachesPtr = &layoutCaches;
+  CKFlexboxPendingMeasurement *const pendingMeasurements = measurements.data();
+  // Each child has its own cached layout, and nested flexbox layouts use the arena of the thread they run on.
+  dispatch_apply(measurements.size(), dispatch_get_global_queue(qos_class_self(), 0), ^(size_t i) {
+    const CK::Component::LayoutSystraceContext systraceContext(systraceListener);
+    const RCConcurrentLayoutCaches::Scope layoutCacheScope(*layoutCachesPtr, i);
+    const CKFlexboxPendingMeasurement &measurement = pendingMeasurements[i];
+    measureChild(measurement.cachedLayout, measurement.width, measurement.widthMode, YGUndefined, YGMeasureModeUndefined);
+  });
 }
 
 #pragma mark - CKMountable
@@ -17,6 +17,7 @@
 #import <ComponentKit/CKInternalHelpers.h>
 #import <ComponentKit/CKSizeAssert.h>
 
+#import "CKComponent+Yoga.h"
 #import "CKComponentSubclass.h"
 #import "RCDimension_SwiftBridge+Internal.h"
 #import "ComponentLayoutContext.h"
@@ -154,6 +155,57 @@ static CGFloat centerInset(CGFloat outer, CGFloat inner)
   return {self, computedSize, {{{x,y}, std::move(childLayout)}}};
 }
 
+#pragma mark - Yoga
+
+/**
+ Whether the inset can be resolved without the parent size, as a finite number of points. Yoga nodes only know the
+ parent size in the dimensions where it is exact.
+ */
+static BOOL isFinitePoints(const RCRelativeDimension &inset)
+{
+  return inset.type() != RCRelativeDimension::Type::PERCENT && !isinf(inset.value());
+}
+
+/**
+ The inset joins the Yoga tree of its parent flexbox if its component does, as a node padded by the insets. Infinite
+ insets, which center the component, and percent insets, which are relative to the parent size, are only supported by
+ -computeLayoutThatFits:.
+ */
+- (BOOL)isYogaBasedLayout
+{
+  return isFinitePoints(_top) && isFinitePoints(_left) && isFinitePoints(_bottom) && isFinitePoints(_right) && [_component isYogaBasedLayout];
+}
+
+- (YGNodeRef)ygNode:(CKSizeRange)constrainedSize
+{
+  if (![self isYogaBasedLayout]) {
+    return [super ygNode:constrainedSize];
+  }
+  const YGNodeRef node = YGNodeNewWithConfig(ckYogaDefaultConfig());
+  const CGSize parentSize = ckYogaParentSize(constrainedSize);
+  YGNodeStyleSetPadding(node, YGEdgeTop, _top.resolve(0, parentSize.height));
+  YGNodeStyleSetPadding(node, YGEdgeLeft, _left.resolve(0, parentSize.width));
+  YGNodeStyleSetPadding(node, YGEdgeBottom, _bottom.resolve(0, parentSize.height));
+  YGNodeStyleSetPadding(node, YGEdgeRight, _right.resolve(0, parentSize.width));
+
+  // The component fills the inset on both axes when its size is exact, like the size range it gets from
+  // -computeLayoutThatFits:, and is sized by its content otherwise.
+  const YGNodeRef childNode = [_component ygNode:constrainedSize];
+  ckYogaApplyNodeSize(childNode, [_component nodeSize], parentSize);
+  YGNodeStyleSetFlexGrow(childNode, 1);
+  YGNodeStyleSetFlexShrink(childNode, 1);
+  YGNodeInsertChild(node, childNode, 0);
+  return node;
+}
+
+- (RCLayout)layoutFromYgNode:(YGNodeRef)layoutNode thatFits:(CKSizeRange)constrainedSize
+{
+  const CGSize size = constrainedSize.clamp({YGNodeLayoutGetWidth(layoutNode), YGNodeLayoutGetHeight(layoutNode)});
+  RCLayoutChild child = ckYogaLayoutChild(_component, YGNodeGetChild(layoutNode, 0), size);
+  YGNodeFreeRecursive(layoutNode);
+  return {self, size, {std::move(child)}};
+}
+
 #pragma mark - CKMountable
 
 - (unsigned int)numberOfChildren
@@ -362,6 +362,32 @@ class __attribute__((__may_alias__)) FlexboxComponentBuilder
     return *this;
   }
 
+  /**
+  If set to @c YES and the component has a tree node, keeps its yoga tree between layout passes and only marks dirty the
+  nodes that changed. Has no effect together with @c useDeepYogaTrees.
+  */
+  auto &useRetainedYogaTree(bool r)
+  {
+    constexpr auto isNotSettingPropertiesForChild = !PropBitmap::isSet(PropsBitmap, FlexboxComponentPropId::hasActiveChild);
+    static_assert(isNotSettingPropertiesForChild,
+                  "Properties for the container must be set before the first call to .child()");
+    _style.useRetainedYogaTree = r;
+    return *this;
+  }
+
+  /**
+  If set to @c YES, measures the children whose constraints are known before the layout is calculated concurrently.
+  Meant for wide containers of expensive children.
+  */
+  auto &measureChildrenConcurrently(bool m)
+  {
+    constexpr auto isNotSettingPropertiesForChild = !PropBitmap::isSet(PropsBitmap, FlexboxComponentPropId::hasActiveChild);
+    static_assert(isNotSettingPropertiesForChild,
+                  "Properties for the container must be set before the first call to .child()");
+    _style.measureChildrenConcurrently = m;
+    return *this;
+  }
+
   /**
    Adds a child component with default layout options to this flexbox component.
 
@@ -199,8 +199,11 @@ static const NSUInteger kBackgroundThreadStackSizeInBytes = 1024 * 1024 * 2; //
     _changesetSplittingEnabled = configuration.options.splitChangesetOptions.enabled;
     [CKComponentDebugController registerReflowListener:self];
     
-    if (CKReadGlobalConfig().enableLayoutCaching) {
-      _treeLayoutCache = std::make_shared<CKTreeLayoutCache>();
+    auto const globalConfig = CKReadGlobalConfig();
+    if (globalConfig.enableLayoutCaching) {
+      _treeLayoutCache = std::make_shared<CKTreeLayoutCache>(globalConfig.enableFlatLayoutCacheTable
+                                                             ? RCLayoutCacheBackendFlatTable
+                                                             : RCLayoutCacheBackendPersistentMap);
     }
   }
   return self;
@@ -527,10 +530,16 @@ static const NSUInteger kBackgroundThreadStackSizeInBytes = 1024 * 1024 * 2; //
   for (NSIndexPath *removedIndex in [appliedChanges removedIndexPaths]) {
     CKDataSourceItem *removedItem = [previousState objectAtIndexPath:removedIndex];
     CKComponentScopeRootAnnounceControllerInvalidation([removedItem scopeRoot]);
+    if (_treeLayoutCache) {
+      _treeLayoutCache->erase([[removedItem scopeRoot] globalIdentifier]);
+    }
   }
   [[appliedChanges removedSections] enumerateIndexesUsingBlock:^(NSUInteger idx, BOOL *) {
     [previousState enumerateObjectsInSectionAtIndex:idx usingBlock:^(CKDataSourceItem *removedItem, NSIndexPath *, BOOL *) {
       CKComponentScopeRootAnnounceControllerInvalidation([removedItem scopeRoot]);
+      if (self->_treeLayoutCache) {
+        self->_treeLayoutCache->erase([[removedItem scopeRoot] globalIdentifier]);
+      }
     }];
   }];
 
@@ -72,8 +72,11 @@ struct CKDataSourceChangesetApplicatorPipelineItem {
     _changesetApplicatorId = @(++globalChangesetApplicatorId);
     [_dataSource addListener:self];
 
-    if (CKReadGlobalConfig().enableLayoutCaching) {
-      _treeLayoutCache = std::make_shared<CKTreeLayoutCache>();
+    auto const globalConfig = CKReadGlobalConfig();
+    if (globalConfig.enableLayoutCaching) {
+      _treeLayoutCache = std::make_shared<CKTreeLayoutCache>(globalConfig.enableFlatLayoutCacheTable
+                                                             ? RCLayoutCacheBackendFlatTable
+                                                             : RCLayoutCacheBackendPersistentMap);
     }
 
     RCAssertNotNil(_queue, @"A dispatch queue must be specified for changeset applicator.");
@@ -192,6 +195,18 @@ struct CKDataSourceChangesetApplicatorPipelineItem {
     auto const willApplyChange = CK::Analytics::willStartAsyncBlock(CK::Analytics::BlockName::ChangeSetApplicatorWillApplyChange);
 
     if (CKReadGlobalConfig().enableLayoutCaching) {
+      if (isValid) {
+        const auto previousState = change.previousState;
+        for (NSIndexPath *removedIndex in [change.appliedChanges removedIndexPaths]) {
+          CKDataSourceItem *removedItem = [previousState objectAtIndexPath:removedIndex];
+          _treeLayoutCache->erase([[removedItem scopeRoot] globalIdentifier]);
+        }
+        [[change.appliedChanges removedSections] enumerateIndexesUsingBlock:^(NSUInteger idx, BOOL *) {
+          [previousState enumerateObjectsInSectionAtIndex:idx usingBlock:^(CKDataSourceItem *removedItem, NSIndexPath *, BOOL *) {
+            self->_treeLayoutCache->erase([[removedItem scopeRoot] globalIdentifier]);
+          }];
+        }];
+      }
       for (NSIndexPath *insertedIndex in [change.appliedChanges insertedIndexPaths]) {
         if ([newState numberOfSections] > insertedIndex.section && [newState numberOfObjectsInSection:insertedIndex.section] > insertedIndex.row) {
           CKDataSourceItem *insertedItem = [newState objectAtIndexPath:insertedIndex];
@@ -56,8 +56,36 @@ struct CKDataSourceSplitChangesetOptions {
   CKDataSourceLayoutAxis layoutAxis = CKDataSourceLayoutAxisVertical;
 };
 
+/**
+ * Configuration for building the items of a changeset concurrently. Each item has its own scope root, so the items
+ * inserted or updated by a changeset can be built and laid out independently; they are still added to the new state
+ * in index order. Analytics listeners are called from several threads while items are built concurrently.
+ */
+struct CKDataSourceItemBuildOptions {
+  /**
+   * The maximum number of items built at the same time by a modification of each quality of service, including the
+   * thread applying the modification. The default of 1 builds the items one after another.
+   */
+  NSUInteger maxConcurrentBuildsDefault = 1;
+  NSUInteger maxConcurrentBuildsUserInitiated = 1;
+  NSUInteger maxConcurrentBuildsUserInteractive = 1;
+
+  NSUInteger maxConcurrentBuilds(CKDataSourceQOS qos) const
+  {
+    switch (qos) {
+      case CKDataSourceQOSDefault:
+        return maxConcurrentBuildsDefault;
+      case CKDataSourceQOSUserInitiated:
+        return maxConcurrentBuildsUserInitiated;
+      case CKDataSourceQOSUserInteractive:
+        return maxConcurrentBuildsUserInteractive;
+    }
+  }
+};
+
 struct CKDataSourceOptions {
   CKDataSourceSplitChangesetOptions splitChangesetOptions;
+  CKDataSourceItemBuildOptions itemBuildOptions;
 };
 
 @interface CKDataSourceConfiguration ()
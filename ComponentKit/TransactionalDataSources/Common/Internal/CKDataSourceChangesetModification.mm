@@ -10,8 +10,12 @@
 
 #import "CKDataSourceChangesetModification.h"
 
+#import <algorithm>
+#import <atomic>
+#import <exception>
 #import <map>
 #import <mutex>
+#import <vector>
 
 #import <ComponentKit/CKExceptionInfo.h>
 
@@ -33,6 +37,7 @@
 #import "CKIndexSetDescription.h"
 #import "CKInvalidChangesetOperationType.h"
 #import "CKFatal.h"
+#import "CKTraitCollectionHelper.h"
 
 using namespace CKComponentControllerHelper;
 
@@ -117,9 +122,15 @@ using namespace CKComponentControllerHelper;
     [newSections addObject:[items mutableCopy]];
   }];
 
+  // The item generator builds items on the thread applying the modification.
+  const NSUInteger maxConcurrentBuilds = _itemGenerator ? 1 : configuration.options.itemBuildOptions.maxConcurrentBuilds(_qos);
+
   // Update items
   NSDictionary<NSIndexPath *, id> *const updatedItems = [_changeset updatedItems];
-  void(^processUpdatedItem)(NSIndexPath *indexPath, id model) = ^(NSIndexPath *indexPath, id model) {
+  NSArray<NSIndexPath *> *const updatedIndexPaths = [updatedItems allKeys];
+  std::vector<CKDataSourceItem *> oldUpdatedItems;
+  oldUpdatedItems.reserve(updatedIndexPaths.count);
+  for (NSIndexPath *indexPath in updatedIndexPaths) {
     if (indexPath.section >= newSections.count) {
       CKCFatalWithCategory(CKHumanReadableInvalidChangesetOperationType(CKInvalidChangesetOperationTypeUpdate),
                            @"Invalid section: %lu (>= %lu). Changeset: %@, user info: %@, state: %@",
@@ -139,16 +150,25 @@ using namespace CKComponentControllerHelper;
                            _userInfo,
                            oldState);
     }
-    CKDataSourceItem *const oldItem = section[indexPath.item];
-    CKDataSourceItem *const item = [self _buildDataSourceItemForPreviousRoot:[oldItem scopeRoot]
-                                                                stateUpdates:{}
-                                                                   sizeRange:sizeRange
-                                                               configuration:configuration
-                                                                       model:model
-                                                                     context:context
-                                                                 layoutCache:_treeLayoutCache ? _treeLayoutCache->find([[oldItem scopeRoot] globalIdentifier]) : nullptr
-                                                                    itemType:CKDataSourceChangesetModificationItemTypeUpdate];
-    [section replaceObjectAtIndex:indexPath.item withObject:item];
+    oldUpdatedItems.push_back(section[indexPath.item]);
+  }
+  const auto oldUpdatedItemsData = oldUpdatedItems.data();
+  const auto newUpdatedItems = buildItems(updatedIndexPaths.count, maxConcurrentBuilds, ^CKDataSourceItem *(NSUInteger idx) {
+    CKDataSourceItem *const oldItem = oldUpdatedItemsData[idx];
+    return [self _buildDataSourceItemForPreviousRoot:[oldItem scopeRoot]
+                                        stateUpdates:{}
+                                           sizeRange:sizeRange
+                                       configuration:configuration
+                                               model:updatedItems[updatedIndexPaths[idx]]
+                                             context:context
+                                         layoutCache:_treeLayoutCache ? _treeLayoutCache->find([[oldItem scopeRoot] globalIdentifier]) : nullptr
+                                            itemType:CKDataSourceChangesetModificationItemTypeUpdate];
+  });
+  for (NSUInteger idx = 0; idx < updatedIndexPaths.count; idx++) {
+    NSIndexPath *const indexPath = updatedIndexPaths[idx];
+    CKDataSourceItem *const oldItem = oldUpdatedItems[idx];
+    CKDataSourceItem *const item = newUpdatedItems[idx];
+    [newSections[indexPath.section] replaceObjectAtIndex:indexPath.item withObject:item];
     for (auto componentController : addedControllersFromPreviousScopeRootMatchingPredicate(item.scopeRoot,
                                                                                                  oldItem.scopeRoot,
                                                                                                  &CKComponentControllerInitializeEventPredicate)) {
@@ -159,10 +179,7 @@ using namespace CKComponentControllerHelper;
                                                                                                    &CKComponentControllerInvalidateEventPredicate)) {
       [invalidComponentControllers addObject:componentController];
     }
-  };
-  [updatedItems enumerateKeysAndObjectsUsingBlock:^(NSIndexPath *indexPath, id model, BOOL *stop) {
-    processUpdatedItem(indexPath, model);
-  }];
+  }
 
   __block std::unordered_map<NSUInteger, std::map<NSUInteger, CKDataSourceItem *>> insertedItemsBySection;
   __block std::unordered_map<NSUInteger, NSMutableIndexSet *> removedItemsBySection;
@@ -263,9 +280,14 @@ using namespace CKComponentControllerHelper;
   };
 
   NSDictionary<NSIndexPath *, id> *const insertedItems = [_changeset insertedItems];
-  [insertedItems enumerateKeysAndObjectsUsingBlock:^(NSIndexPath *indexPath, id model, BOOL *stop) {
-    insertedItemsBySection[indexPath.section][indexPath.item] = buildItem(model);
-  }];
+  NSArray<NSIndexPath *> *const insertedIndexPaths = [insertedItems allKeys];
+  const auto newInsertedItems = buildItems(insertedIndexPaths.count, maxConcurrentBuilds, ^CKDataSourceItem *(NSUInteger idx) {
+    return buildItem(insertedItems[insertedIndexPaths[idx]]);
+  });
+  for (NSUInteger idx = 0; idx < insertedIndexPaths.count; idx++) {
+    NSIndexPath *const indexPath = insertedIndexPaths[idx];
+    insertedItemsBySection[indexPath.section][indexPath.item] = newInsertedItems[idx];
+  }
 
   for (const auto &sectionIt : insertedItemsBySection) {
     NSMutableIndexSet *indexes = [NSMutableIndexSet indexSet];
@@ -350,6 +372,58 @@ using namespace CKComponentControllerHelper;
   return [_changeset description];
 }
 
+/**
+ Builds `count` items with `buildItem` and returns them in index order. Up to `maxConcurrentBuilds` items are built at
+ the same time, on worker threads of the quality of service of the calling thread, which also builds items.
+ An exception raised while building an item is raised again on the calling thread once the workers are done.
+ */
+static std::vector<CKDataSourceItem *> buildItems(NSUInteger count,
+                                                  NSUInteger maxConcurrentBuilds,
+                                                  CKDataSourceItem *(^buildItem)(NSUInteger idx))
+{
+  std::vector<CKDataSourceItem *> items(count);
+  const auto workerCount = std::min(count, maxConcurrentBuilds);
+  if (workerCount <= 1) {
+    for (NSUInteger idx = 0; idx < count; idx++) {
+      items[idx] = buildItem(idx);
+    }
+    return items;
+  }
+
+  // Workers don't inherit the trait collection the modification is applied with.
+  UITraitCollection *traitCollection = nil;
+  if (@available(iOS 13.0, tvOS 13.0, *)) {
+    traitCollection = [UITraitCollection currentTraitCollection];
+  }
+  __strong CKDataSourceItem **const itemsData = items.data();
+  std::atomic<NSUInteger> nextIndex{0};
+  const auto nextIndexPtr = &nextIndex;
+  std::mutex exceptionMutex;
+  const auto exceptionMutexPtr = &exceptionMutex;
+  std::exception_ptr exception;
+  const auto exceptionPtr = &exception;
+  dispatch_apply(workerCount, dispatch_get_global_queue(qos_class_self(), 0), ^(size_t) {
+    CKPerformWithCurrentTraitCollection(traitCollection, ^{
+      for (auto idx = (*nextIndexPtr)++; idx < count; idx = (*nextIndexPtr)++) {
+        try {
+          itemsData[idx] = buildItem(idx);
+        } catch (...) {
+          std::lock_guard<std::mutex> l(*exceptionMutexPtr);
+          if (!*exceptionPtr) {
+            *exceptionPtr = std::current_exception();
+          }
+          // Let the other workers run out of items.
+          *nextIndexPtr = count;
+        }
+      }
+    });
+  });
+  if (exception) {
+    std::rethrow_exception(exception);
+  }
+  return items;
+}
+
 static NSArray *emptyMutableArrays(NSUInteger count)
 {
   NSMutableArray *arrays = [NSMutableArray array];
@@ -0,0 +1,67 @@
+/*
+ *  Copyright (c) 2014-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#import <XCTest/XCTest.h>
+
+#import <ComponentKit/CKTreeNode.h>
+
+// Each iteration builds one generation of a parent whose children are all of the same type, like a list of
+// identical rows, keying and looking up every child in the previous generation.
+
+#define TEST_ITERATIONS 20
+
+@interface CKTreeNodePerfTests : XCTestCase
+@end
+
+@implementation CKTreeNodePerfTests
+
+- (void)testPerformanceWith10Children
+{
+  [self measureGenerationsOfParentWithChildCount:10 iterations:TEST_ITERATIONS * 100];
+}
+
+- (void)testPerformanceWith100Children
+{
+  [self measureGenerationsOfParentWithChildCount:100 iterations:TEST_ITERATIONS * 10];
+}
+
+- (void)testPerformanceWith1000Children
+{
+  [self measureGenerationsOfParentWithChildCount:1000 iterations:TEST_ITERATIONS];
+}
+
+- (void)measureGenerationsOfParentWithChildCount:(NSUInteger)childCount iterations:(NSUInteger)iterations
+{
+  static const char *const kRowTypeName = "Row";
+  std::vector<CKTreeNode *> children;
+  for (NSUInteger i = 0; i < childCount; i++) {
+    children.push_back([CKTreeNode rootNode]);
+  }
+
+  [self measureBlock:^{
+    CKTreeNode *previousParent = [CKTreeNode rootNode];
+    for (NSUInteger i = 0; i < iterations; i++) {
+      CKTreeNode *const parent = [CKTreeNode rootNode];
+      NSUInteger reusedChildCount = 0;
+      for (CKTreeNode *child : children) {
+        const auto key = [parent createKeyForComponentTypeName:kRowTypeName
+                                                    identifier:nil
+                                                          keys:{}
+                                                          type:CKTreeNodeComponentKey::Type::parent];
+        reusedChildCount += [previousParent childForComponentKey:key] != nil;
+        [parent setChild:child forComponentKey:key];
+      }
+      XCTAssertEqual(reusedChildCount, i == 0 ? 0 : childCount);
+      previousParent = parent;
+    }
+  }];
+}
+
+@end
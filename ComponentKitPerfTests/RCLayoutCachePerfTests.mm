@@ -0,0 +1,156 @@
+/*
+ *  Copyright (c) 2014-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#import <XCTest/XCTest.h>
+
+#import <unordered_map>
+#import <vector>
+
+#import <ComponentKit/RCPersistentMap.h>
+#import <RenderCore/CKMountable.h>
+#import <RenderCoreLayoutCaching/RCLayoutCacheTable.h>
+
+// Roughly the number of components in a large tree, each looked up a few times per layout pass.
+
+#define MOUNTABLE_COUNT 2000
+#define LOOKUPS_PER_MOUNTABLE 4
+#define TEST_ITERATIONS 20
+
+namespace {
+  struct KeyHash {
+    size_t operator()(const RCLayoutCacheKey &key) const noexcept
+    {
+      return key.constrainingSize.hash();
+    }
+  };
+
+  /** The layout cache before the flat table backend: a map of maps, whose inner hash ignores the parent size. */
+  using NestedMapCache = std::unordered_map<id<CKMountable>, std::unordered_map<RCLayoutCacheKey, RCLayout, KeyHash>, RC::hash<id>>;
+  using PersistentMapEntries = std::vector<std::pair<RCLayoutCacheKey, RCLayout>>;
+  using PersistentMapCache = RC::PersistentMap<id<CKMountable>, std::shared_ptr<const PersistentMapEntries>, RC::hash<id>>;
+}
+
+@interface RCLayoutCachePerfTests : XCTestCase
+@end
+
+@implementation RCLayoutCachePerfTests
+{
+  std::vector<id<CKMountable>> _mountables;
+  RCLayoutCacheKey _key;
+}
+
+- (void)setUp
+{
+  [super setUp];
+  _mountables.clear();
+  for (auto i = 0; i < MOUNTABLE_COUNT; i++) {
+    _mountables.push_back((id<CKMountable>)[NSObject new]);
+  }
+  _key = {CKSizeRange {{0, 0}, {320, INFINITY}}, {320, NAN}};
+}
+
+- (void)testPerformanceWithNestedMaps
+{
+  [self measureBlock:^{
+    for (auto i = 0; i < TEST_ITERATIONS; i++) {
+      NestedMapCache cache;
+      for (const auto &m : _mountables) {
+        cache[m].emplace(_key, RCLayout {});
+      }
+      NSUInteger hits = 0;
+      for (auto j = 0; j < LOOKUPS_PER_MOUNTABLE; j++) {
+        for (const auto &m : _mountables) {
+          const auto it = cache.find(m);
+          hits += it != cache.end() && it->second.find(_key) != it->second.end();
+        }
+      }
+      XCTAssertEqual(hits, MOUNTABLE_COUNT * LOOKUPS_PER_MOUNTABLE);
+    }
+  }];
+}
+
+- (void)testPerformanceWithPersistentMap
+{
+  [self measureBlock:^{
+    for (auto i = 0; i < TEST_ITERATIONS; i++) {
+      // Each miss allocates its entries and inserts them in place, like a layout pass does.
+      PersistentMapCache cache;
+      for (const auto &m : _mountables) {
+        cache.insertInPlace(m, std::make_shared<const PersistentMapEntries>(PersistentMapEntries {{_key, RCLayout {}}}));
+      }
+      NSUInteger hits = 0;
+      for (auto j = 0; j < LOOKUPS_PER_MOUNTABLE; j++) {
+        for (const auto &m : _mountables) {
+          const auto entries = cache.find(m);
+          hits += entries != nullptr && (*entries)->front().first == _key;
+        }
+      }
+      XCTAssertEqual(hits, MOUNTABLE_COUNT * LOOKUPS_PER_MOUNTABLE);
+    }
+  }];
+}
+
+- (void)testPerformanceWithFlatTable
+{
+  [self measureBlock:^{
+    for (auto i = 0; i < TEST_ITERATIONS; i++) {
+      RCLayoutCacheTable cache;
+      for (const auto &m : _mountables) {
+        cache.insert(m, _key, RCLayout {});
+      }
+      NSUInteger hits = 0;
+      for (auto j = 0; j < LOOKUPS_PER_MOUNTABLE; j++) {
+        for (const auto &m : _mountables) {
+          hits += cache.find(m, _key) != nullptr;
+        }
+      }
+      XCTAssertEqual(hits, MOUNTABLE_COUNT * LOOKUPS_PER_MOUNTABLE);
+    }
+  }];
+}
+
+- (void)testPerformanceOfCarryingOverEntriesWithFlatTable
+{
+  RCLayoutCacheTable previous;
+  for (const auto &m : _mountables) {
+    previous.insert(m, _key, RCLayout {});
+  }
+  [self measureBlock:^{
+    for (auto i = 0; i < TEST_ITERATIONS; i++) {
+      RCLayoutCacheTable next {previous.size()};
+      for (const auto &m : _mountables) {
+        previous.copyEntriesOfMountable(m, next);
+      }
+      XCTAssertEqual(next.size(), previous.size());
+    }
+  }];
+}
+
+/** The persistent map carries its entries over in O(1); this measures keeping the entries of a pass's layout. */
+- (void)testPerformanceOfKeepingEntriesWithPersistentMap
+{
+  PersistentMapCache previous;
+  for (const auto &m : _mountables) {
+    previous.insertInPlace(m, std::make_shared<const PersistentMapEntries>(PersistentMapEntries {{_key, RCLayout {}}}));
+  }
+  [self measureBlock:^{
+    for (auto i = 0; i < TEST_ITERATIONS; i++) {
+      PersistentMapCache next;
+      for (const auto &m : _mountables) {
+        if (const auto entries = previous.find(m)) {
+          next.insertInPlace(m, *entries);
+        }
+      }
+      XCTAssertEqual(next.size(), previous.size());
+    }
+  }];
+}
+
+@end
@@ -32,12 +32,16 @@ using Event = Variant<DidReceiveStateUpdate>;
 @property(atomic, readonly) NSInteger didBuildComponentTreeHitCount;
 @property(atomic, readonly) NSInteger willLayoutComponentTreeHitCount;
 @property(atomic, readonly) NSInteger didLayoutComponentTreeHitCount;
+/** How many of the didLayoutComponentTree calls were made on the main thread. */
+@property(atomic, readonly) NSInteger didLayoutComponentTreeOnMainThreadHitCount;
+@property(atomic, readonly) NSInteger didProcessLayoutHitCount;
 @property(atomic, readonly) NSInteger willCollectAnimationsHitCount;
 @property(atomic, readonly) NSInteger didCollectAnimationsHitCount;
 @property(atomic, readonly) NSInteger willMountComponentHitCount;
 @property(atomic, readonly) NSInteger didMountComponentHitCount;
 @property(atomic, readonly) NSInteger viewAllocationsCount;
 @property(atomic, readonly) std::vector<CK::AnalyticsListenerSpy::Event> events;
+@property(atomic, readonly) std::vector<NSUInteger> coalescedStateUpdateBatchSizes;
 
 @end
 
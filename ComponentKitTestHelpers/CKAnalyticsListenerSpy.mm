@@ -19,6 +19,8 @@ using namespace CK::AnalyticsListenerSpy;
 @property(atomic) NSInteger didBuildComponentTreeHitCount;
 @property(atomic) NSInteger willLayoutComponentTreeHitCount;
 @property(atomic) NSInteger didLayoutComponentTreeHitCount;
+@property(atomic) NSInteger didLayoutComponentTreeOnMainThreadHitCount;
+@property(atomic) NSInteger didProcessLayoutHitCount;
 @property(atomic) NSInteger willCollectAnimationsHitCount;
 @property(atomic) NSInteger didCollectAnimationsHitCount;
 @property(atomic) NSInteger willMountComponentHitCount;
@@ -29,8 +31,9 @@ using namespace CK::AnalyticsListenerSpy;
   NSUInteger _viewAllocationsCount;
   NSUInteger _didMountComponentHitCount;
   std::vector<CK::AnalyticsListenerSpy::Event> _events;
+  std::vector<NSUInteger> _coalescedStateUpdateBatchSizes;
 }
-@dynamic viewAllocationsCount, didMountComponentHitCount, events;
+@dynamic viewAllocationsCount, didMountComponentHitCount, events, coalescedStateUpdateBatchSizes;
 
 - (instancetype)init {
   self = [super init];
@@ -91,6 +94,12 @@ inComponentTreeWithRootComponent:(id<CKMountable>)component
 }
 - (void)didLayoutComponentTreeWithRootComponent:(id<CKMountable>)component {
   self.didLayoutComponentTreeHitCount++;
+  if ([NSThread isMainThread]) {
+    self.didLayoutComponentTreeOnMainThreadHitCount++;
+  }
+}
+- (void)didProcessLayoutOfComponentTreeWithRootComponent:(id<CKMountable>)component duration:(CFTimeInterval)duration {
+  self.didProcessLayoutHitCount++;
 }
 
 - (void)willBuildComponent:(Class)componentClass {}
@@ -124,6 +133,14 @@ inComponentTreeWithRootComponent:(id<CKMountable>)component
   });
 }
 
+- (void)didCoalesceStateUpdates:(NSUInteger)stateUpdateCount
+                       withMode:(CKUpdateMode)mode
+                 rootIdentifier:(CKComponentScopeRootIdentifier)rootID {
+  dispatch_sync(_propertyAccessQueue, ^{
+    _coalescedStateUpdateBatchSizes.push_back(stateUpdateCount);
+  });
+}
+
 - (NSInteger)didMountComponentHitCount {
   __block NSInteger result;
   dispatch_sync(_propertyAccessQueue, ^{ result = _didMountComponentHitCount; });
@@ -142,4 +159,10 @@ inComponentTreeWithRootComponent:(id<CKMountable>)component
   return result;
 }
 
+- (std::vector<NSUInteger>)coalescedStateUpdateBatchSizes {
+  __block std::vector<NSUInteger> result;
+  dispatch_sync(_propertyAccessQueue, ^{ result = _coalescedStateUpdateBatchSizes; });
+  return result;
+}
+
 @end
@@ -282,6 +282,34 @@ CK_LAYOUT_COMPONENT_INIT_UNAVAILABLE;
   XCTAssertEqualObjects(CKComponentContextHelper::fetchAll().objects, nil);
 }
 
+- (void)testRenderComponentsCreatedWithTheSameItemsShareTheirSnapshot
+{
+  NSObject *o1 = [NSObject new];
+  NSObject *o2 = [NSObject new];
+
+  CKComponent *component1;
+  CKComponent *component2;
+  {
+    CKComponentTestRootScope testScope;
+    component1 = [CKComponent new];
+    component2 = [CKComponent new];
+  }
+
+  CKComponentMutableContext<NSObject> context1(o1);
+  CKComponentContextHelper::didCreateRenderComponent(component1);
+  CKComponentContextHelper::didCreateRenderComponent(component2);
+  auto const snapshot = CKComponentContextHelper::takeComponentTreeContext(component1);
+  XCTAssertEqual(snapshot, CKComponentContextHelper::takeComponentTreeContext(component2));
+
+  // Changing the store doesn't change the snapshot.
+  CKComponentMutableContext<NSObject> context2(o2);
+  CKComponentContextHelper::setComponentTreeContext(component1, snapshot);
+  CKComponentContextHelper::willBuildComponentTree(component1);
+  XCTAssertTrue(CKComponentMutableContext<NSObject>::get() == o1);
+  CKComponentContextHelper::didBuildComponentTree(component1);
+  XCTAssertTrue(CKComponentMutableContext<NSObject>::get() == o2);
+}
+
 #pragma mark - Initial Values
 
 - (void)testInitialValues
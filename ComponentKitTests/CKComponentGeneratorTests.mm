@@ -44,7 +44,10 @@
 @implementation CKComponentGeneratorTests
 {
   CK::Optional<CKBuildComponentResult> _asyncComponentGenerationResult;
+  NSUInteger _asyncComponentGenerationCount;
   BOOL _didReceiveComponentStateUpdate;
+  NSUInteger _componentStateUpdateCount;
+  CKUpdateMode _componentStateUpdateMode;
 }
 
 static CKComponent *verificationComponentProvider(id<NSObject> m, id<NSObject> c)
@@ -91,6 +94,17 @@ static CKComponent *verificationComponentProvider(id<NSObject> m, id<NSObject> c
   });
 }
 
+- (void)testGenerateComponentAynchronouslyTwice_FirstGenerationIsCancelled
+{
+  const auto componentGenerator = [self createComponentGenerator];
+  [componentGenerator generateComponentAsynchronously];
+  [componentGenerator generateComponentAsynchronously];
+  CKRunRunLoopUntilBlockIsTrue(^BOOL{
+    return _asyncComponentGenerationResult.hasValue() && componentGenerator.cancellationStats.cancelledGenerations == 1;
+  });
+  XCTAssertEqual(_asyncComponentGenerationCount, 1);
+}
+
 - (void)testIgnoreComponentReuseInNextGeneration_ComponentIsNotReused
 {
   const auto componentGenerator = [self createComponentGenerator];
@@ -145,6 +159,33 @@ static CKComponent *verificationComponentProvider(id<NSObject> m, id<NSObject> c
   });
 }
 
+- (void)testStateUpdatesBeforeNextFrame_AreDeliveredOnceWithTheStrictestMode
+{
+  const auto analyticsListenerSpy = [CKAnalyticsListenerSpy new];
+  const auto componentGenerator =
+  [[CKComponentGenerator alloc] initWithOptions:{
+    .delegate = CK::makeNonNull(self),
+    .componentProvider = CK::makeNonNull([](id<NSObject> m, id<NSObject> c) -> CKComponent *{
+      return [CKTestStateComponent new];
+    }),
+    .analyticsListener = analyticsListenerSpy,
+    .coalescesStateUpdatesUntilNextFrame = YES,
+  }];
+  const auto result1 = [componentGenerator generateComponentSynchronously];
+
+  [result1.component updateState:^(id currentState) { return currentState; } mode:CKUpdateModeAsynchronous];
+  [result1.component updateState:^(id currentState) { return currentState; } mode:CKUpdateModeSynchronous];
+  [result1.component updateState:^(id currentState) { return currentState; } mode:CKUpdateModeAsynchronous];
+  XCTAssertFalse(_didReceiveComponentStateUpdate);
+
+  CKRunRunLoopUntilBlockIsTrue(^BOOL{
+    return _didReceiveComponentStateUpdate;
+  });
+  XCTAssertEqual(_componentStateUpdateCount, 1);
+  XCTAssertEqual(_componentStateUpdateMode, CKUpdateModeSynchronous);
+  XCTAssertTrue(analyticsListenerSpy.coalescedStateUpdateBatchSizes == std::vector<NSUInteger>{3});
+}
+
 - (void)test_WhenReceivedPropsUpdateAndStateUpdate_BuildTriggerShouldBePropsUpdate
 {
   const auto componentGenerator =
@@ -204,11 +245,14 @@ static CKComponent *verificationComponentProvider(id<NSObject> m, id<NSObject> c
 - (void)componentGenerator:(CKComponentGenerator *)componentGenerator didReceiveComponentStateUpdateWithMode:(CKUpdateMode)mode
 {
   _didReceiveComponentStateUpdate = YES;
+  _componentStateUpdateCount++;
+  _componentStateUpdateMode = mode;
 }
 
 - (void)componentGenerator:(CKComponentGenerator *)componentGenerator didAsynchronouslyGenerateComponentResult:(CKBuildComponentResult)result
 {
   _asyncComponentGenerationResult = result;
+  _asyncComponentGenerationCount++;
 }
 
 @end
@@ -33,6 +33,7 @@ typedef struct {
   id<CKComponentSizeRangeProviding> sizeRangeProvider;
   CK::Optional<CGSize> initialSize;
   BOOL shouldUpdateModelAfterCreation = YES;
+  BOOL laysOutAsynchronously;
   void(^willGenerateComponent)();
 } CKComponentHostingViewConfiguration;
 
@@ -77,6 +78,7 @@ static CKComponent *CKComponentTestComponentProviderFunc(id<NSObject> model, id<
                                                            options:{
                                                              .allowTapPassthrough = options.allowTapPassthrough,
                                                              .initialSize = options.initialSize,
+                                                             .laysOutAsynchronously = options.laysOutAsynchronously,
                                                            }];
 }
 
@@ -409,6 +411,31 @@ static CKComponent *CKComponentTestComponentProviderFunc(id<NSObject> model, id<
   XCTAssertEqual(_analyticsListenerSpy.didMountComponentHitCount, 1);
 }
 
+- (void)test_LayoutOfComponentIsNotOnMainThreadWhenAsyncUpdateIsTriggeredWithAsynchronousLayout
+{
+  const auto hostingView = [[self class] hostingView:{
+    .analyticsListener = _analyticsListenerSpy,
+    .laysOutAsynchronously = YES,
+  }];
+  hostingView.delegate = self;
+  XCTAssertEqual(_analyticsListenerSpy.didLayoutComponentTreeHitCount, 1);
+  XCTAssertEqual(_analyticsListenerSpy.didMountComponentHitCount, 1);
+  const auto mainThreadLayoutCount = _analyticsListenerSpy.didLayoutComponentTreeOnMainThreadHitCount;
+
+  [hostingView updateContext:@"foo" mode:CKUpdateModeAsynchronous];
+  XCTAssertTrue(CKRunRunLoopUntilBlockIsTrue(^BOOL{
+    return _calledSizeDidInvalidate;
+  }));
+  // The new component was laid out in the background before its result was applied on the main thread.
+  XCTAssertEqual(_analyticsListenerSpy.didLayoutComponentTreeHitCount, 2);
+  XCTAssertEqual(_analyticsListenerSpy.didLayoutComponentTreeOnMainThreadHitCount, mainThreadLayoutCount);
+
+  [hostingView layoutIfNeeded];
+  XCTAssertEqual(_analyticsListenerSpy.didLayoutComponentTreeHitCount, 2);
+  XCTAssertEqual(_analyticsListenerSpy.didLayoutComponentTreeOnMainThreadHitCount, mainThreadLayoutCount);
+  XCTAssertEqual(_analyticsListenerSpy.didMountComponentHitCount, 2);
+}
+
 - (void)test_CurrentTraitCollectionIsCorrectInBackgroundQueueWhenTraitCollectionIsSet
 {
   if (@available(iOS 13.0, tvOS 13.0, *)) {
@@ -448,6 +475,7 @@ static CKComponent *CKComponentTestComponentProviderFunc(id<NSObject> model, id<
                                                                options:{
                                                                  .allowTapPassthrough = options.allowTapPassthrough,
                                                                  .initialSize = options.initialSize,
+                                                                 .laysOutAsynchronously = options.laysOutAsynchronously,
                                                                }];
 }
 
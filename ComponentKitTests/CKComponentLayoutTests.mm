@@ -17,6 +17,7 @@
 #import <ComponentKit/CKComponentLayout.h>
 #import <ComponentKit/CKCompositeComponent.h>
 #import <ComponentKit/CKFlexboxComponent.h>
+#import <ComponentKitTestHelpers/CKAnalyticsListenerSpy.h>
 #import <ComponentKitTestHelpers/CKTestRunLoopRunning.h>
 
 @interface CKLayoutTestComponentController : CKComponentController
@@ -85,6 +86,41 @@
   }
 }
 
+- (void)testComputeRootLayout_ReportsPostLayoutProcessing
+{
+  __block NSArray<CKComponent *> *children;
+  __block CKComponent *c;
+  CKBuildComponent(CKComponentScopeRootWithDefaultPredicates(nil, nil), {}, ^{
+    children = createChildrenArray(YES);
+    c = flexboxComponentWithScopedChildren(children);
+    return c;
+  });
+
+  CKAnalyticsListenerSpy *const spy = [CKAnalyticsListenerSpy new];
+  const auto layout = CKComputeRootComponentLayout(c, {{200, 0}, {200, INFINITY}}, spy);
+
+  XCTAssertEqual(spy.didProcessLayoutHitCount, 1);
+  XCTAssertEqual(spy.didLayoutComponentTreeHitCount, 1);
+  XCTAssertTrue(layout.cachedLayoutForComponent(children.firstObject).component == children.firstObject);
+}
+
+- (void)testTreeLayoutCache_SnapshotsAreNotAffectedByLaterUpdates
+{
+  CKTreeLayoutCache treeLayoutCache;
+  const auto firstCache = RCLayoutCacheCreate(RCLayoutCacheBackendPersistentMap);
+  treeLayoutCache.update(1, firstCache);
+  treeLayoutCache.update(2, RCLayoutCacheCreate(RCLayoutCacheBackendPersistentMap));
+
+  const CKTreeLayoutCache snapshot = treeLayoutCache;
+  treeLayoutCache.update(1, RCLayoutCacheCreate(RCLayoutCacheBackendPersistentMap));
+  treeLayoutCache.erase(2);
+
+  XCTAssertEqual(snapshot.size(), 2);
+  XCTAssertTrue(snapshot.find(1) == firstCache);
+  XCTAssertEqual(treeLayoutCache.size(), 1);
+  XCTAssertTrue(treeLayoutCache.find(1) != firstCache);
+}
+
 #pragma mark - Helpers
 
 static CKComponent* flexboxComponentWithScopedChildren(NSArray<CKComponent *> *children) {
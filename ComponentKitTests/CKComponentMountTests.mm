@@ -18,6 +18,7 @@
 #import <ComponentKit/CKLayoutComponent.h>
 #import <ComponentKit/CKMountableHelpers.h>
 #import <ComponentKit/CKMountedObjectForView.h>
+#import <ComponentKitTestHelpers/CKTestRunLoopRunning.h>
 
 #import "CKComponentTestCase.h"
 
@@ -110,6 +111,197 @@ CK_LAYOUT_COMPONENT_INIT_UNAVAILABLE;
   XCTAssertNil(b.viewContext.view, @"Should not be mounted");
 }
 
+- (void)testIncrementalMountSkipsUnchangedSubtree
+{
+  CKComponent *root = CK::ComponentBuilder()
+                          .viewClass([UIView class])
+                          .build();
+  CKComponent *a = CK::ComponentBuilder()
+                       .viewClass([UIView class])
+                       .build();
+  CKComponent *b = CK::ComponentBuilder()
+                       .viewClass([UIView class])
+                       .build();
+
+  const RCLayout layout = {root, {10, 10},
+    {
+      {CGPointZero, {a, {5, 5}}},
+      {{5, 5}, {b, {5, 5}}},
+    }
+  };
+
+  UIView *container = [UIView new];
+  RCIncrementalMountState state;
+  NSSet *firstMount = CKMountComponentLayout(layout, container, nil, nil, nil, &state);
+  XCTAssertEqual(state.skippedComponentCount, 0u);
+
+  NSSet *secondMount = CKMountComponentLayout(layout, container, firstMount, nil, nil, &state);
+  XCTAssertEqual(state.skippedComponentCount, 2u);
+  XCTAssertEqualObjects(secondMount, firstMount);
+  XCTAssertNotNil(a.viewContext.view, @"Skipped component should still be mounted");
+  XCTAssertFalse(a.viewContext.view.hidden, @"Skipped component's view should not be hidden");
+  XCTAssertFalse(b.viewContext.view.hidden, @"Skipped component's view should not be hidden");
+
+  const RCLayout changedLayout = {root, {10, 10},
+    {
+      {CGPointZero, {a, {5, 5}}},
+    }
+  };
+  NSSet *thirdMount = CKMountComponentLayout(changedLayout, container, secondMount, nil, nil, &state);
+  XCTAssertEqual(state.skippedComponentCount, 0u);
+  XCTAssertNil(b.viewContext.view, @"Should not be mounted");
+
+  CKUnmountComponents(thirdMount);
+}
+
+- (void)testIncrementalMountReleasesReplacedComponentsWhenAnotherSubtreeIsSkipped
+{
+  UIView *container = [UIView new];
+  RCIncrementalMountState state;
+  __weak CKComponent *weakFirstBody = nil;
+  __weak CKComponent *weakFirstBodyChild = nil;
+  NSSet *mounted = nil;
+
+  @autoreleasepool {
+    CKComponent *root = CK::ComponentBuilder()
+                            .viewClass([UIView class])
+                            .build();
+    CKComponent *header = CK::ComponentBuilder()
+                              .viewClass([UIView class])
+                              .build();
+    CKComponent *headerChild = CK::ComponentBuilder()
+                                   .viewClass([UIView class])
+                                   .build();
+    // Reused as is by every generation, so that the header is skipped after the first mount.
+    const RCLayout headerLayout = {header, {10, 5},
+      {
+        {CGPointZero, {headerChild, {5, 5}}},
+      }
+    };
+
+    for (int generation = 0; generation < 3; generation++) {
+      @autoreleasepool {
+        // A new body replaces the previous one in every generation.
+        CKComponent *body = CK::ComponentBuilder()
+                                .viewClass([UIView class])
+                                .build();
+        CKComponent *bodyChild = CK::ComponentBuilder()
+                                     .viewClass([UIView class])
+                                     .build();
+        const RCLayout layout = {root, {10, 10},
+          {
+            {CGPointZero, headerLayout},
+            {{0, 5}, {body, {10, 5},
+              {
+                {CGPointZero, {bodyChild, {5, 5}}},
+              }
+            }},
+          }
+        };
+        if (generation == 0) {
+          weakFirstBody = body;
+          weakFirstBodyChild = bodyChild;
+        }
+        mounted = CKMountComponentLayout(layout, container, mounted, nil, nil, &state);
+        XCTAssertEqual(state.skippedComponentCount, generation == 0 ? 0u : 1u);
+      }
+    }
+  }
+
+  XCTAssertNil(weakFirstBody, @"Replaced component should not be kept alive by the incremental mount state");
+  XCTAssertNil(weakFirstBodyChild, @"Replaced component should not be kept alive by the incremental mount state");
+
+  CKUnmountComponents(mounted);
+}
+
+- (void)testResumableMountMountsOneComponentPerSliceWhenOverBudgetAndUnmountsAtTheEnd
+{
+  CKComponent *root = CK::ComponentBuilder()
+                          .viewClass([UIView class])
+                          .build();
+  CKComponent *a = CK::ComponentBuilder()
+                       .viewClass([UIView class])
+                       .build();
+  CKComponent *b = CK::ComponentBuilder()
+                       .viewClass([UIView class])
+                       .build();
+  CKComponent *old = CK::ComponentBuilder()
+                         .viewClass([UIView class])
+                         .build();
+
+  UIView *container = [UIView new];
+  NSSet *oldMounted = CKMountComponentLayout({old, {10, 10}}, container, nil, nil);
+
+  const RCLayout layout = {root, {10, 10},
+    {
+      {CGPointZero, {a, {5, 5}}},
+      {{5, 5}, {b, {5, 5}}},
+    }
+  };
+  RCResumableLayoutMount mount {layout, container, oldMounted, nil, nullptr, nil};
+
+  XCTAssertFalse(mount.mountUntil(0));
+  XCTAssertEqualObjects(mount.mountedComponents(), [NSSet setWithObject:root]);
+  XCTAssertNotNil(old.viewContext.view, @"Previously mounted components should stay mounted until the mount finishes");
+
+  XCTAssertFalse(mount.mountUntil(0));
+  XCTAssertNotNil(a.viewContext.view);
+  XCTAssertNil(b.viewContext.view);
+
+  XCTAssertTrue(mount.mountUntil(0));
+  XCTAssertTrue(mount.isFinished());
+  XCTAssertNotNil(b.viewContext.view);
+  XCTAssertNil(old.viewContext.view, @"Previously mounted components should be unmounted once the mount finishes");
+
+  CKUnmountComponents(mount.mountedComponents());
+}
+
+- (void)testTimeSlicedMountMountsTheWholeLayoutOverSeveralRunLoopTurns
+{
+  CKComponent *root = CK::ComponentBuilder()
+                          .viewClass([UIView class])
+                          .build();
+  CKComponent *a = CK::ComponentBuilder()
+                       .viewClass([UIView class])
+                       .build();
+  CKComponent *b = CK::ComponentBuilder()
+                       .viewClass([UIView class])
+                       .build();
+  CKComponent *old = CK::ComponentBuilder()
+                         .viewClass([UIView class])
+                         .build();
+
+  UIView *container = [UIView new];
+  NSSet *oldMounted = CKMountComponentLayout({old, {10, 10}}, container, nil, nil);
+
+  const RCLayout layout = {root, {10, 10},
+    {
+      {CGPointZero, {a, {5, 5}}},
+      {{5, 5}, {b, {5, 5}}},
+    }
+  };
+  __block NSSet<id<CKMountable>> *completedMountedComponents = nil;
+  // With no budget, each runloop turn mounts a single component.
+  const auto mount = CKMountComponentLayoutTimeSliced(layout, container, oldMounted, nil, nil, 0, ^(NSSet<id<CKMountable>> *mountedComponents) {
+    completedMountedComponents = mountedComponents;
+  });
+
+  // The first slice is mounted synchronously, next to the components of the previous layout.
+  XCTAssertNil(completedMountedComponents);
+  XCTAssertNotNil(root.viewContext.view);
+  XCTAssertNil(b.viewContext.view);
+  XCTAssertNotNil(old.viewContext.view);
+
+  XCTAssertTrue(CKRunRunLoopUntilBlockIsTrue(^BOOL{
+    return completedMountedComponents != nil;
+  }));
+  XCTAssertTrue(mount->isFinished());
+  XCTAssertEqualObjects(completedMountedComponents, ([NSSet setWithObjects:root, a, b, nil]));
+  XCTAssertNil(old.viewContext.view);
+
+  CKUnmountComponents(completedMountedComponents);
+}
+
 - (void)testPerformMount
 {
   const auto viewConfig = CKComponentViewConfiguration {
@@ -10,10 +10,18 @@
 
 #import <XCTest/XCTest.h>
 
+#import <atomic>
+
 #import <ComponentKit/CKFlexboxComponent.h>
 #import <ComponentKit/CKCompositeComponent.h>
+#import <ComponentKit/CKBackgroundLayoutComponent.h>
+#import <ComponentKit/CKCenterLayoutComponent.h>
+#import <ComponentKit/CKInsetComponent.h>
+#import <ComponentKit/CKRatioLayoutComponent.h>
 #import <ComponentKit/CKComponentLayout.h>
 #import <ComponentKit/CKComponent+Yoga.h>
+#import <ComponentKit/CKComponentSubclass.h>
+#import <ComponentKit/CKTreeNode.h>
 
 #import "yoga/Yoga.h"
 
@@ -23,6 +31,63 @@
 
 - (YGNodeRef)ygNode:(CKSizeRange)constrainedSize;
 - (RCLayout)layoutThatFits:(CKSizeRange)constrainedSize parentSize:(CGSize)parentSize;
+- (BOOL)canUseStackLayoutThatFits:(CKSizeRange)constrainedSize;
+- (RCLayout)computeStackLayoutThatFits:(CKSizeRange)constrainedSize;
+- (RCLayout)computeYogaLayoutThatFits:(CKSizeRange)constrainedSize;
+
+@end
+
+static NSUInteger layoutCountingComponentLayoutCount = 0;
+static std::vector<std::pair<CKComponent *, CKSizeRange>> layoutCountingComponentSizeRanges;
+
+@interface CKLayoutCountingComponent : CKComponent
+@end
+
+@implementation CKLayoutCountingComponent
+
+- (RCLayout)computeLayoutThatFits:(CKSizeRange)constrainedSize
+{
+  layoutCountingComponentLayoutCount++;
+  layoutCountingComponentSizeRanges.push_back({self, constrainedSize});
+  return {self, constrainedSize.clamp({50, 20})};
+}
+
+@end
+
+static std::atomic<NSUInteger> concurrentLayoutCountingComponentLayoutCount;
+
+@interface CKConcurrentLayoutCountingComponent : CKComponent
+@end
+
+@implementation CKConcurrentLayoutCountingComponent
+
+- (RCLayout)computeLayoutThatFits:(CKSizeRange)constrainedSize
+{
+  concurrentLayoutCountingComponentLayoutCount++;
+  return {self, constrainedSize.clamp({50, 20})};
+}
+
+@end
+
+@interface CKIntrinsicSizeComponent : CKComponent
++ (instancetype)newWithIntrinsicSize:(CGSize)intrinsicSize;
+@end
+
+@implementation CKIntrinsicSizeComponent {
+  CGSize _intrinsicSize;
+}
+
++ (instancetype)newWithIntrinsicSize:(CGSize)intrinsicSize
+{
+  CKIntrinsicSizeComponent *const c = [self new];
+  c->_intrinsicSize = intrinsicSize;
+  return c;
+}
+
+- (RCLayout)computeLayoutThatFits:(CKSizeRange)constrainedSize
+{
+  return {self, constrainedSize.clamp(_intrinsicSize)};
+}
 
 @end
 
@@ -465,6 +530,327 @@
   XCTAssertTrue(areLayoutsEqual(buildComponentTreeAndComputeLayout(NO), buildComponentTreeAndComputeLayout(YES)));
 }
 
+- (void)testSameLayoutIsCalculatedWithAndWithoutDeepYogaTreesThroughInsetAndBackgroundComponents
+{
+  RCLayout(^buildComponentTreeAndComputeLayout)(BOOL) = ^RCLayout(BOOL useDeepYogaTrees) {
+    CKComponent *(^rowWithChildren)(void) = ^CKComponent *{
+      return
+      CK::FlexboxComponentBuilder()
+          .direction(CKFlexboxDirectionRow)
+          .alignItems(CKFlexboxAlignItemsStart)
+          .spacing(5)
+          .useDeepYogaTrees(useDeepYogaTrees)
+          .child([CKIntrinsicSizeComponent newWithIntrinsicSize:{50, 30}])
+          .child([CKIntrinsicSizeComponent newWithIntrinsicSize:{20, 40}])
+          .build();
+    };
+    CKComponent *component =
+    CK::FlexboxComponentBuilder()
+        .alignItems(CKFlexboxAlignItemsStart)
+        .spacing(5)
+        .useDeepYogaTrees(useDeepYogaTrees)
+        .child([[CKInsetComponent alloc] initWithTop:10 left:15 bottom:5 right:0 component:rowWithChildren()])
+        .child([[CKBackgroundLayoutComponent alloc] initWithComponent:rowWithChildren()
+                                                           background:CK::ComponentBuilder()
+                                                                          .viewClass([UIView class])
+                                                                          .build()])
+        .build();
+
+    const CKSizeRange kSize = {{500, 500}, {500, 500}};
+    return [component layoutThatFits:kSize parentSize:kSize.max];
+  };
+
+  XCTAssertTrue(areLayoutsEqual(buildComponentTreeAndComputeLayout(NO), buildComponentTreeAndComputeLayout(YES)));
+}
+
+- (void)testSameLayoutIsCalculatedWithAndWithoutDeepYogaTreesThroughPercentInsetComponent
+{
+  CKInsetComponent *(^insetRow)(BOOL) = ^CKInsetComponent *(BOOL useDeepYogaTrees) {
+    return [[CKInsetComponent alloc] initWithTop:RCRelativeDimension::Percent(0.1)
+                                            left:RCRelativeDimension::Percent(0.05)
+                                          bottom:5
+                                           right:0
+                                       component:CK::FlexboxComponentBuilder()
+                                                     .direction(CKFlexboxDirectionRow)
+                                                     .useDeepYogaTrees(useDeepYogaTrees)
+                                                     .child([CKIntrinsicSizeComponent newWithIntrinsicSize:{50, 30}])
+                                                     .build()];
+  };
+  RCLayout(^buildComponentTreeAndComputeLayout)(BOOL) = ^RCLayout(BOOL useDeepYogaTrees) {
+    CKComponent *component =
+    CK::FlexboxComponentBuilder()
+        .alignItems(CKFlexboxAlignItemsStart)
+        .useDeepYogaTrees(useDeepYogaTrees)
+        .child(insetRow(useDeepYogaTrees))
+        .build();
+
+    // The height is not exact, so Yoga nodes don't know the parent height.
+    const CKSizeRange kSize = {{500, 0}, {500, 400}};
+    return [component layoutThatFits:kSize parentSize:{500, 400}];
+  };
+
+  XCTAssertFalse([insetRow(YES) isYogaBasedLayout]);
+  XCTAssertTrue(areLayoutsEqual(buildComponentTreeAndComputeLayout(NO), buildComponentTreeAndComputeLayout(YES)));
+}
+
+- (void)testSameLayoutIsCalculatedWithAndWithoutDeepYogaTreesThroughCenterAndRatioComponents
+{
+  for (const auto alignItems : {CKFlexboxAlignItemsStart, CKFlexboxAlignItemsStretch}) {
+    RCLayout(^buildComponentTreeAndComputeLayout)(BOOL) = ^RCLayout(BOOL useDeepYogaTrees) {
+      CKComponent *(^rowWithChildren)(void) = ^CKComponent *{
+        return
+        CK::FlexboxComponentBuilder()
+            .direction(CKFlexboxDirectionRow)
+            .alignItems(CKFlexboxAlignItemsStart)
+            .spacing(5)
+            .useDeepYogaTrees(useDeepYogaTrees)
+            .child([CKIntrinsicSizeComponent newWithIntrinsicSize:{50, 30}])
+            .child([CKIntrinsicSizeComponent newWithIntrinsicSize:{20, 40}])
+            .build();
+      };
+      CKComponent *component =
+      CK::FlexboxComponentBuilder()
+          .alignItems(alignItems)
+          .spacing(5)
+          .useDeepYogaTrees(useDeepYogaTrees)
+          .child([[CKCenterLayoutComponent alloc] initWithCenteringOptions:CKCenterLayoutComponentCenteringXY
+                                                             sizingOptions:CKCenterLayoutComponentSizingOptionMinimumY
+                                                                     child:rowWithChildren()
+                                                                      size:{}])
+          .child([CKRatioLayoutComponent newWithRatio:0.5 size:{} component:rowWithChildren()])
+          .build();
+
+      const CKSizeRange kSize = {{500, 500}, {500, 500}};
+      return [component layoutThatFits:kSize parentSize:kSize.max];
+    };
+
+    XCTAssertTrue(areLayoutsEqual(buildComponentTreeAndComputeLayout(NO), buildComponentTreeAndComputeLayout(YES)));
+  }
+}
+
+- (void)testCenterAndRatioLayoutComponentsAreNotPartOfDeepYogaTrees
+{
+  CKComponent *(^child)(void) = ^CKComponent *{
+    return
+    CK::FlexboxComponentBuilder()
+        .useDeepYogaTrees(YES)
+        .child([CKIntrinsicSizeComponent newWithIntrinsicSize:{50, 30}])
+        .build();
+  };
+  CKComponent *const center = [[CKCenterLayoutComponent alloc] initWithCenteringOptions:CKCenterLayoutComponentCenteringXY
+                                                                          sizingOptions:CKCenterLayoutComponentSizingOptionDefault
+                                                                                  child:child()
+                                                                                   size:{}];
+  CKComponent *const ratio = [CKRatioLayoutComponent newWithRatio:0.5 size:{} component:child()];
+
+  XCTAssertFalse([center isYogaBasedLayout]);
+  XCTAssertFalse([ratio isYogaBasedLayout]);
+}
+
+static CKComponent *flexboxWithChildren(std::vector<CKFlexboxComponentChild> children, BOOL useRetainedYogaTree, CKTreeNode *treeNode)
+{
+  CKFlexboxComponent *const flexbox =
+  [CKFlexboxComponent newWithView:{}
+                             size:{}
+                            style:{.spacing = 5, .alignItems = CKFlexboxAlignItemsStart, .useRetainedYogaTree = useRetainedYogaTree}
+                         children:std::move(children)];
+  [flexbox acquireTreeNode:treeNode];
+  return flexbox;
+}
+
+- (void)testRetainedYogaTreeComputesTheSameLayoutAsATemporaryOneAcrossGenerations
+{
+  const CKSizeRange kSize = {{0, 0}, {500, 500}};
+  CKComponent *const a = [CKLayoutCountingComponent new];
+  CKComponent *const b = [CKLayoutCountingComponent new];
+  CKComponent *const c = [CKLayoutCountingComponent new];
+  const std::vector<std::vector<CKFlexboxComponentChild>> generations = {
+    {{a}, {b}},
+    {{a}, {.component = b, .spacingBefore = 10, .flexGrow = 1}, {c}},
+    {{.component = c, .zIndex = 1}, {a}},
+    {{a}},
+  };
+
+  CKTreeNode *treeNode = nil;
+  for (const auto &children : generations) {
+    treeNode = [[CKTreeNode alloc] initWithPreviousNode:treeNode scopeHandle:nil];
+    const RCLayout retainedLayout = [flexboxWithChildren(children, YES, treeNode) layoutThatFits:kSize parentSize:kSize.max];
+    const RCLayout layout = [flexboxWithChildren(children, NO, nil) layoutThatFits:kSize parentSize:kSize.max];
+    XCTAssertTrue(areLayoutsEqual(retainedLayout, layout));
+  }
+  XCTAssertNotNil(treeNode.retainedLayoutState);
+}
+
+- (void)testRetainedYogaTreeDoesNotLayOutUnchangedChildrenAgain
+{
+  const CKSizeRange kSize = {{0, 0}, {500, 500}};
+  CKComponent *const a = [CKLayoutCountingComponent new];
+  CKComponent *const b = [CKLayoutCountingComponent new];
+
+  CKTreeNode *const firstNode = [[CKTreeNode alloc] initWithPreviousNode:nil scopeHandle:nil];
+  [flexboxWithChildren({{a}, {b}}, YES, firstNode) layoutThatFits:kSize parentSize:kSize.max];
+
+  layoutCountingComponentLayoutCount = 0;
+  CKTreeNode *const secondNode = [[CKTreeNode alloc] initWithPreviousNode:firstNode scopeHandle:nil];
+  const RCLayout layout = [flexboxWithChildren({{a}, {b}}, YES, secondNode) layoutThatFits:kSize parentSize:kSize.max];
+  XCTAssertEqual(layoutCountingComponentLayoutCount, 0);
+  XCTAssertEqual(layout.children->size(), 2);
+
+  CKComponent *const newB = [CKLayoutCountingComponent new];
+  CKTreeNode *const thirdNode = [[CKTreeNode alloc] initWithPreviousNode:secondNode scopeHandle:nil];
+  [flexboxWithChildren({{a}, {newB}}, YES, thirdNode) layoutThatFits:kSize parentSize:kSize.max];
+  XCTAssertGreaterThan(layoutCountingComponentLayoutCount, 0);
+}
+
+- (void)testChildIsNotLaidOutTwiceWithTheSameSizeRangeInOneCalculation
+{
+  CKComponent *const child = [CKLayoutCountingComponent new];
+  CKComponent *const flexbox =
+  [CKFlexboxComponent newWithView:{}
+                             size:{}
+                            style:{.direction = CKFlexboxDirectionRow, .alignItems = CKFlexboxAlignItemsStretch}
+                         children:{
+                           {.component = child, .flexGrow = 1, .flexShrink = 1},
+                           {.component = [CKLayoutCountingComponent new], .flexShrink = 1},
+                         }];
+
+  layoutCountingComponentSizeRanges.clear();
+  const CKSizeRange kSize = {{0, 0}, {80, 100}};
+  [flexbox layoutThatFits:kSize parentSize:kSize.max];
+
+  const auto &ranges = layoutCountingComponentSizeRanges;
+  for (size_t i = 0; i < ranges.size(); i++) {
+    for (size_t j = i + 1; j < ranges.size(); j++) {
+      XCTAssertFalse(ranges[i] == ranges[j], @"%@ was laid out twice with %@", ranges[i].first, ranges[i].second.description());
+    }
+  }
+}
+
+- (void)testStackLayoutComputesTheSameLayoutAsYoga
+{
+  const std::vector<CKSizeRange> sizeRanges = {
+    {{300, 200}, {300, 200}},
+    {{0, 0}, {300, 200}},
+    {{250, 150}, {300, 200}},
+    {{40, 10}, {60, 30}},
+    {{0, 0}, {INFINITY, INFINITY}},
+    {{100.3, 0}, {100.3, INFINITY}},
+    {{0, 33.4}, {INFINITY, 33.4}},
+    {{17.7, 9.1}, {201.9, 99.9}},
+  };
+  const std::vector<CKFlexboxJustifyContent> justifications = {
+    CKFlexboxJustifyContentStart,
+    CKFlexboxJustifyContentCenter,
+    CKFlexboxJustifyContentEnd,
+    CKFlexboxJustifyContentSpaceBetween,
+    CKFlexboxJustifyContentSpaceAround,
+    CKFlexboxJustifyContentSpaceEvenly,
+  };
+  const std::vector<CKFlexboxAlignItems> alignments = {
+    CKFlexboxAlignItemsStart,
+    CKFlexboxAlignItemsCenter,
+    CKFlexboxAlignItemsEnd,
+    CKFlexboxAlignItemsStretch,
+  };
+  const std::vector<CKFlexboxAlignSelf> selfAlignments = {
+    CKFlexboxAlignSelfAuto,
+    CKFlexboxAlignSelfStart,
+    CKFlexboxAlignSelfEnd,
+    CKFlexboxAlignSelfCenter,
+    CKFlexboxAlignSelfStretch,
+  };
+  const std::vector<CGFloat> spacings = {0, 2.5, 1.0 / 3.0};
+  // Single children, fractional sizes, empty children and children that overflow the stack.
+  const std::vector<std::vector<CGSize>> childSizeLists = {
+    {{33.3, 21.7}, {50, 10}, {20.5, 40.25}},
+    {{10.0 / 3.0, 7.0 / 3.0}},
+    {{0, 0}, {12.6, 0}, {0, 8.8}},
+    {{180.1, 120.7}, {150.35, 90.15}},
+  };
+
+  NSUInteger comparedLayoutCount = 0;
+  for (const auto direction : {CKFlexboxDirectionRow, CKFlexboxDirectionColumn}) {
+    for (const auto justifyContent : justifications) {
+      for (const auto alignItems : alignments) {
+        for (const auto spacing : spacings) {
+          for (const auto &childSizes : childSizeLists) {
+            for (const auto alignSelf : selfAlignments) {
+              std::vector<CKFlexboxComponentChild> children;
+              for (size_t i = 0; i < childSizes.size(); i++) {
+                children.push_back({
+                  .component = [CKIntrinsicSizeComponent newWithIntrinsicSize:childSizes[i]],
+                  .spacingBefore = i == 1 ? 4.0 : 0,
+                  .spacingAfter = i == 0 ? 1.5 : 0,
+                  // Only one child aligns itself, so that the others follow alignItems.
+                  .alignSelf = i == childSizes.size() - 1 ? alignSelf : CKFlexboxAlignSelfAuto,
+                  .zIndex = i == 0 ? -1 : 0,
+                });
+                if (i == 0) {
+                  children.push_back({nil});
+                }
+              }
+              CKFlexboxComponent *const flexbox =
+              [CKFlexboxComponent newWithView:{}
+                                         size:{}
+                                        style:{.direction = direction, .spacing = spacing, .justifyContent = justifyContent, .alignItems = alignItems, .layoutDirection = CKLayoutDirectionLTR}
+                                     children:std::move(children)];
+              for (const auto &sizeRange : sizeRanges) {
+                if (![flexbox canUseStackLayoutThatFits:sizeRange]) {
+                  continue;
+                }
+                const RCLayout stackLayout = [flexbox computeStackLayoutThatFits:sizeRange];
+                const RCLayout yogaLayout = [flexbox computeYogaLayoutThatFits:sizeRange];
+                XCTAssertTrue(areLayoutsEqual(stackLayout, yogaLayout), @"%@ in %@", flexbox, sizeRange.description());
+                comparedLayoutCount++;
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+  XCTAssertGreaterThan(comparedLayoutCount, 0);
+}
+
+- (void)testStackLayoutIsNotUsedForFlexibleChildren
+{
+  CKFlexboxComponent *const flexbox =
+  [CKFlexboxComponent newWithView:{}
+                             size:{}
+                            style:{}
+                         children:{
+                           {[CKIntrinsicSizeComponent newWithIntrinsicSize:{50, 20}]},
+                           {.component = [CKIntrinsicSizeComponent newWithIntrinsicSize:{50, 20}], .flexGrow = 1},
+                         }];
+  XCTAssertFalse([flexbox canUseStackLayoutThatFits:{{0, 0}, {100, 100}}]);
+}
+
+- (void)testConcurrentlyMeasuredChildrenAreLaidOutOnceAndTheSameAsSerially
+{
+  RCLayout(^buildComponentTreeAndComputeLayout)(BOOL) = ^RCLayout(BOOL measureChildrenConcurrently) {
+    std::vector<CKFlexboxComponentChild> children;
+    for (int i = 0; i < 8; i++) {
+      children.push_back({.component = [CKConcurrentLayoutCountingComponent new], .spacingBefore = 5});
+    }
+    CKComponent *const flexbox =
+    [CKFlexboxComponent newWithView:{}
+                               size:{}
+                              style:{.measureChildrenConcurrently = measureChildrenConcurrently}
+                           children:std::move(children)];
+    const CKSizeRange kSize = {{300, 0}, {300, INFINITY}};
+    return [flexbox layoutThatFits:kSize parentSize:kSize.max];
+  };
+
+  concurrentLayoutCountingComponentLayoutCount = 0;
+  const RCLayout serialLayout = buildComponentTreeAndComputeLayout(NO);
+  const NSUInteger serialLayoutCount = concurrentLayoutCountingComponentLayoutCount;
+  concurrentLayoutCountingComponentLayoutCount = 0;
+  const RCLayout concurrentLayout = buildComponentTreeAndComputeLayout(YES);
+
+  XCTAssertTrue(areLayoutsEqual(serialLayout, concurrentLayout));
+  XCTAssertEqual(concurrentLayoutCountingComponentLayoutCount.load(), serialLayoutCount);
+}
+
 - (void)test_WhenUsingBothChildAndChildren_ChildrenAreAddedInSameOrder
 {
   auto const a = CK::ComponentBuilder().build();
@@ -12,8 +12,10 @@
 
 #import <ComponentKit/CKBuildComponent.h>
 #import <ComponentKit/CKComponentInternal.h>
+#import <ComponentKit/CKComponentLayout.h>
 #import <ComponentKit/CKComponentSubclass.h>
 #import <ComponentKit/CKFlexboxComponent.h>
+#import <ComponentKit/CKGenerationToken.h>
 #import <ComponentKit/CKThreadLocalComponentScope.h>
 #import <ComponentKit/CKTreeNode.h>
 #import <ComponentKit/CKComponentScopeRootFactory.h>
@@ -625,6 +627,65 @@
   XCTAssertFalse(c2.didReuseComponent);
 }
 
+- (void)test_cancelledGeneration_doesNotRenderComponents
+{
+  __block CKTestRenderComponent *c;
+  auto const componentFactory = ^{
+    c = [CKTestRenderComponent newWithProps:{}];
+    return [CKTestLayoutComponent newWithChildren:{c}];
+  };
+
+  CKGenerationToken generationToken;
+  generationToken.cancel();
+  CKGenerationToken::Scope generationTokenScope(&generationToken);
+  auto const scopeRoot = CKComponentScopeRootWithPredicates(nil, nil, {}, {});
+  auto const buildTrigger = CKBuildComponentTrigger(scopeRoot, {}, NO, NO);
+  CKBuildComponent(scopeRoot, {}, componentFactory, buildTrigger, CKReflowTriggerNone);
+
+  XCTAssertEqual(c.renderCalledCounter, 0);
+  XCTAssertNil(c.childComponent);
+}
+
+- (void)test_cancelledStateUpdate_leavesThePreviousGenerationUnchanged
+{
+  __block CKTestRenderWithNonRenderWithStateChildComponent *c1;
+  __block CKTestRenderWithNonRenderWithStateChildComponent *c2;
+  auto const componentFactory = ^{
+    c1 = [CKTestRenderWithNonRenderWithStateChildComponent new];
+    c2 = [CKTestRenderWithNonRenderWithStateChildComponent new];
+    return [CKTestLayoutComponent newWithChildren:{c1, c2}];
+  };
+
+  // Build first component generation:
+  auto const scopeRoot = CKComponentScopeRootWithPredicates(nil, nil, {}, {});
+  auto const buildTrigger = CKBuildComponentTrigger(scopeRoot, {}, NO, NO);
+  auto const buildResults = CKBuildComponent(scopeRoot, {}, componentFactory, buildTrigger, CKReflowTriggerNone);
+  auto const rootComponent = buildResults.scopeRoot.rootComponent;
+  auto const previousC1 = c1;
+  auto const previousC1Child = c1.childComponent;
+  auto const previousC1State = c1.state;
+
+  // Cancel a state update on c1:
+  CKComponentStateUpdateMap stateUpdates;
+  stateUpdates[c1.treeNode.scopeHandle].push_back(^(id){ return @10; });
+  {
+    CKGenerationToken generationToken;
+    generationToken.cancel();
+    CKGenerationToken::Scope generationTokenScope(&generationToken);
+    auto const buildTrigger2 = CKBuildComponentTrigger(buildResults.scopeRoot, stateUpdates, NO, NO);
+    CKBuildComponent(buildResults.scopeRoot, stateUpdates, componentFactory, buildTrigger2, CKReflowTriggerNone);
+
+    // The first generation can still be laid out while the cancelled one is around.
+    auto const rootLayout = CKComputeRootComponentLayout(buildResults.component, {CGSizeZero, {100, 100}});
+    XCTAssertEqual(rootLayout.component(), buildResults.component);
+  }
+
+  XCTAssertEqual(buildResults.scopeRoot.rootComponent, rootComponent);
+  XCTAssertEqual(previousC1.childComponent, previousC1Child);
+  XCTAssertEqual(previousC1.state, previousC1State);
+  XCTAssertFalse(previousC1.didReuseComponent);
+}
+
 #pragma mark - Helpers
 
 // Filters `CKTestChildRenderComponent` components.
@@ -939,4 +1000,56 @@ static CKCompositeComponentWithScopeAndState* generateComponentHierarchyWithComp
   XCTAssertFalse(c1Child.didReuseComponent);
 }
 
+- (void)test_buildingRenderChildrenConcurrently_buildsTheSameTreeAsBuildingThemInOrder
+{
+  __block std::vector<CKTestRenderComponent *> components;
+  auto const buildComponentTree = ^CKComponentScopeRoot *(BOOL buildsChildrenConcurrently){
+    components.clear();
+    std::vector<CKComponent *> children;
+    for (NSUInteger i = 0; i < 8; i++) {
+      // Two components with each identifier, to check the counters of the keys.
+      auto const c = [CKTestRenderComponent newWithProps:{.identifier = i / 2}];
+      components.push_back(c);
+      children.push_back(c);
+    }
+    auto const scopeRoot = CKComponentScopeRootWithPredicates(nil, nil,
+                                                              {&CKComponentRenderTestsPredicate},
+                                                              {&CKComponentControllerRenderTestsPredicate});
+    CKThreadLocalComponentScope threadScope(scopeRoot, {});
+    CKComponentScopeRoot *newScopeRoot = threadScope.newScopeRoot;
+    CKRender::ComponentTree::Root::build([CKTestLayoutComponent newWithChildren:children], {
+      .scopeRoot = newScopeRoot,
+      .previousScopeRoot = scopeRoot,
+      .stateUpdates = {},
+      .treeNodeDirtyIds = {},
+      .buildTrigger = CKBuildTriggerPropsUpdate,
+      .buildsChildrenConcurrently = buildsChildrenConcurrently,
+    });
+    return newScopeRoot;
+  };
+
+  auto const scopeRoot = buildComponentTree(NO);
+  auto const concurrentScopeRoot = buildComponentTree(YES);
+
+  // Verify the nodes are keyed as if the children were built in order.
+  auto const nodes = [scopeRoot.rootNode.node() children];
+  auto const concurrentNodes = [concurrentScopeRoot.rootNode.node() children];
+  XCTAssertEqual(nodes.size(), concurrentNodes.size());
+  for (size_t i = 0; i < std::min(nodes.size(), concurrentNodes.size()); i++) {
+    XCTAssertTrue(nodes[i].componentKey == concurrentNodes[i].componentKey);
+    XCTAssertEqual([nodes[i] children].size(), [concurrentNodes[i] children].size());
+    XCTAssertEqual(concurrentScopeRoot.rootNode.parentForNodeIdentifier(concurrentNodes[i].nodeIdentifier),
+                   concurrentScopeRoot.rootNode.node());
+  }
+
+  // Verify the components and controllers built on other threads are registered in the scope root.
+  auto const registeredComponents = [concurrentScopeRoot componentsMatchingPredicate:&CKComponentRenderTestsPredicate];
+  auto const registeredControllers = [concurrentScopeRoot componentControllersMatchingPredicate:&CKComponentControllerRenderTestsPredicate];
+  XCTAssertEqual(registeredComponents.size(), components.size());
+  for (auto const &c : components) {
+    XCTAssertTrue(CK::Collection::contains(registeredComponents, c.childComponent));
+    XCTAssertTrue(CK::Collection::contains(registeredControllers, c.childComponent.controller));
+  }
+}
+
 @end
@@ -20,6 +20,8 @@
 #import <ComponentKit/CKLayoutComponent.h>
 #import <ComponentKit/CKComponentInternal.h>
 #import <ComponentKit/CKButtonComponent.h>
+#import <ComponentKit/CKRenderHelpers.h>
+#import <ComponentKit/CKRootTreeNode.h>
 #import <ComponentKit/CKThreadLocalComponentScope.h>
 #import <ComponentKit/CKBuildComponent.h>
 
@@ -193,6 +195,82 @@ static CKComponent* buildComponent(CKComponent*(^block)()) {
   XCTAssertTrue(areTreesEqual(root, root2));
 }
 
+- (void)test_childForComponentKey_onCKTreeNodeWithChildren_withManyChildrenOverGenerations
+{
+  auto const scopeRoot = CKComponentScopeRootWithDefaultPredicates(nil, nil);
+  NSArray<id<CKRenderComponentProtocol>> *(^buildComponents)(void) = ^{
+    NSMutableArray<id<CKRenderComponentProtocol>> *components = [NSMutableArray array];
+    for (NSUInteger i = 0; i < 50; i++) {
+      switch (i % 3) {
+        case 0:
+          [components addObject:[CKTreeNodeTest_RenderComponent_NoInitialState new]];
+          break;
+        case 1:
+          [components addObject:[CKTreeNodeTest_RenderComponent_WithState new]];
+          break;
+        default:
+          [components addObject:[CKTreeNodeTest_RenderComponent_WithIdentifier newWithIdentifier:@(i % 2)]];
+          break;
+      }
+    }
+    return components;
+  };
+
+  auto const root1 = [CKTreeNode rootNode];
+  auto const components1 = buildComponents();
+  NSMutableArray<CKTreeNode *> *nodes1 = createsNodesForComponentsWithOwner(root1, nil, scopeRoot, components1);
+
+  auto const root2 = [CKTreeNode rootNode];
+  auto const components2 = buildComponents();
+  NSMutableArray<CKTreeNode *> *nodes2 = createsNodesForComponentsWithOwner(root2, root1, [scopeRoot newRoot], components2);
+
+  for (NSUInteger i = 0; i < components1.count; i++) {
+    XCTAssertTrue(verifyChildToParentConnection(root1, nodes1[i], components1[i]));
+    XCTAssertTrue(verifyChildToParentConnection(root2, nodes2[i], components2[i]));
+    XCTAssertEqual(nodes1[i].nodeIdentifier, nodes2[i].nodeIdentifier);
+  }
+}
+
+- (void)test_parentNodeIdentifier_onCKTreeNodeWithChildren_isKeptWhenTheParentIsReused
+{
+  auto const scopeRoot = CKComponentScopeRootWithDefaultPredicates(nil, nil);
+  auto const root = [CKTreeNode rootNode];
+  auto const component = [CKTreeNodeTest_RenderComponent_NoInitialState new];
+  CKTreeNode *parentNode = [CKTreeNode childPairForComponent:component
+                                                      parent:root
+                                              previousParent:nil
+                                                   scopeRoot:scopeRoot
+                                                stateUpdates:{}].node;
+  auto const childComponent = [CKTreeNodeTest_RenderComponent_NoInitialState new];
+  CKTreeNode *childNode = [CKTreeNode childPairForComponent:childComponent
+                                                     parent:parentNode
+                                             previousParent:nil
+                                                  scopeRoot:scopeRoot
+                                               stateUpdates:{}].node;
+  XCTAssertEqual(parentNode.parentNodeIdentifier, 0);
+  XCTAssertEqual(childNode.parentNodeIdentifier, parentNode.nodeIdentifier);
+
+  // Reuse the parent in a new generation.
+  auto const newScopeRoot = [scopeRoot newRoot];
+  auto const newRoot = [CKTreeNode rootNode];
+  auto const newComponent = [CKTreeNodeTest_RenderComponent_NoInitialState new];
+  CKTreeNode *newParentNode = [CKTreeNode childPairForComponent:newComponent
+                                                         parent:newRoot
+                                                 previousParent:root
+                                                      scopeRoot:newScopeRoot
+                                                   stateUpdates:{}].node;
+  [newParentNode reusePreviousNode:parentNode inScopeRoot:newScopeRoot];
+
+  XCTAssertEqual(newParentNode.nodeIdentifier, parentNode.nodeIdentifier);
+  XCTAssertEqual([newParentNode children].front(), childNode);
+  XCTAssertEqual(childNode.parentNodeIdentifier, newParentNode.nodeIdentifier);
+
+  // The path of the child leads up to the root through the identifiers of the new generation.
+  CKTreeNodeDirtyIds dirtyNodeIds;
+  CKRender::markTreeNodeDirtyIdsFromNodeUntilRoot(childNode, dirtyNodeIds);
+  XCTAssertEqual(dirtyNodeIds, (CKTreeNodeDirtyIds{childNode.nodeIdentifier, newParentNode.nodeIdentifier}));
+}
+
 - (void)test_childForComponentKey_onCKTreeNodeWithChildren_withDifferentChildOverGenerations
 {
   // Simulate first component tree creation
@@ -0,0 +1,204 @@
+/*
+ *  Copyright (c) 2014-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#import <XCTest/XCTest.h>
+
+#import <ComponentKit/CKComponent.h>
+#import <ComponentKit/CKComponentSubclass.h>
+#import <ComponentKit/CKFlexboxComponent.h>
+#import <RenderCoreLayoutCaching/RCComputeRootLayout.h>
+
+/** Always 120x44, whatever the size range, as long as the range admits it. */
+@interface RCFixedSizeLeafComponent : CKComponent
+@property (nonatomic, assign) NSUInteger layoutCount;
+@end
+
+@implementation RCFixedSizeLeafComponent
+- (RCLayout)computeLayoutThatFits:(CKSizeRange)constrainedSize
+{
+  _layoutCount++;
+  return {self, constrainedSize.clamp({120, 44})};
+}
+@end
+
+@interface RCMonotonicFixedSizeLeafComponent : RCFixedSizeLeafComponent
+@end
+
+@implementation RCMonotonicFixedSizeLeafComponent
++ (BOOL)hasMonotonicSizing
+{
+  return YES;
+}
+@end
+
+/** Lays out its child through the layout cache, like CKRenderComponent does when layout caching is enabled. */
+@interface RCCachingWrapperComponent : CKComponent
++ (instancetype)newWithChild:(CKComponent *)child;
+@end
+
+@implementation RCCachingWrapperComponent
+{
+  CKComponent *_child;
+}
+
++ (instancetype)newWithChild:(CKComponent *)child
+{
+  const auto c = [super newWithView:{} size:{}];
+  if (c) {
+    c->_child = child;
+  }
+  return c;
+}
+
+static RCLayout layoutChild(id<CKMountable> child, const CKSizeRange &sizeRange, CGSize parentSize)
+{
+  return [child layoutThatFits:sizeRange parentSize:parentSize];
+}
+
+- (RCLayout)computeLayoutThatFits:(CKSizeRange)constrainedSize
+                 restrictedToSize:(const RCComponentSize &)size
+             relativeToParentSize:(CGSize)parentSize
+{
+  const auto l = RCFetchOrComputeLayout(_child, constrainedSize, parentSize, &layoutChild);
+  return {self, l.size, {{{0, 0}, l}}};
+}
+@end
+
+@interface RCComputeRootLayoutTests : XCTestCase
+@end
+
+@implementation RCComputeRootLayoutTests
+
+- (void)testLayoutOfMonotonicComponentIsReusedForSizeRangeContainingItsSize
+{
+  for (const auto backend : {RCLayoutCacheBackendPersistentMap, RCLayoutCacheBackendFlatTable}) {
+    const auto leaf = [RCMonotonicFixedSizeLeafComponent newWithView:{} size:{}];
+    const auto root = [RCCachingWrapperComponent newWithChild:leaf];
+
+    // Both size ranges have the same maximum, which RCComputeRootLayout passes on as the parent size.
+    const auto measured = RCComputeRootLayout(root, {{0, 0}, {375, INFINITY}}, RCLayoutCacheCreate(backend));
+    const auto laidOut = RCComputeRootLayout(root, {{100, 0}, {375, INFINITY}}, measured.cache);
+
+    XCTAssertEqual(leaf.layoutCount, 1);
+    XCTAssertTrue(CGSizeEqualToSize(laidOut.layout.size, CGSizeMake(120, 44)));
+    XCTAssertEqual(RCLayoutCacheGetStatistics(*measured.cache).misses, 1);
+    XCTAssertEqual(RCLayoutCacheGetStatistics(*laidOut.cache).subsumedHits, 1);
+    XCTAssertEqual(RCLayoutCacheGetStatistics(*laidOut.cache).exactHits, 0);
+  }
+}
+
+- (void)testLayoutOfMonotonicComponentIsReusedForDifferentParentSize
+{
+  for (const auto backend : {RCLayoutCacheBackendPersistentMap, RCLayoutCacheBackendFlatTable}) {
+    const auto leaf = [RCMonotonicFixedSizeLeafComponent newWithView:{} size:{}];
+    const auto root = [RCCachingWrapperComponent newWithChild:leaf];
+
+    const auto portrait = RCComputeRootLayout(root, {{0, 0}, {375, INFINITY}}, RCLayoutCacheCreate(backend));
+    const auto landscape = RCComputeRootLayout(root, {{0, 0}, {414, INFINITY}}, portrait.cache);
+
+    XCTAssertEqual(leaf.layoutCount, 1);
+    XCTAssertTrue(CGSizeEqualToSize(landscape.layout.size, CGSizeMake(120, 44)));
+    XCTAssertEqual(RCLayoutCacheGetStatistics(*landscape.cache).subsumedHits, 1);
+    XCTAssertEqual(RCLayoutCacheGetStatistics(*landscape.cache).misses, 0);
+  }
+}
+
+- (void)testLayoutOfMonotonicComponentWithPercentSizeIsNotReusedForDifferentParentSize
+{
+  for (const auto backend : {RCLayoutCacheBackendPersistentMap, RCLayoutCacheBackendFlatTable}) {
+    const auto leaf = [RCMonotonicFixedSizeLeafComponent newWithView:{} size:{.maxWidth = RCRelativeDimension::Percent(0.5)}];
+    const auto root = [RCCachingWrapperComponent newWithChild:leaf];
+
+    const auto portrait = RCComputeRootLayout(root, {{0, 0}, {375, INFINITY}}, RCLayoutCacheCreate(backend));
+    const auto landscape = RCComputeRootLayout(root, {{0, 0}, {414, INFINITY}}, portrait.cache);
+
+    XCTAssertEqual(leaf.layoutCount, 2);
+    XCTAssertEqual(RCLayoutCacheGetStatistics(*landscape.cache).subsumedHits, 0);
+    XCTAssertEqual(RCLayoutCacheGetStatistics(*landscape.cache).misses, 1);
+  }
+}
+
+- (void)testLayoutIsNotReusedForSizeRangeThatExcludesItsSize
+{
+  const auto leaf = [RCMonotonicFixedSizeLeafComponent newWithView:{} size:{}];
+  const auto root = [RCCachingWrapperComponent newWithChild:leaf];
+
+  const auto wide = RCComputeRootLayout(root, {{0, 0}, {375, INFINITY}}, RCLayoutCacheCreate(RCLayoutCacheBackendPersistentMap));
+  const auto narrow = RCComputeRootLayout(root, {{0, 0}, {100, INFINITY}}, wide.cache);
+
+  XCTAssertEqual(leaf.layoutCount, 2);
+  XCTAssertEqual(RCLayoutCacheGetStatistics(*narrow.cache).misses, 1);
+}
+
+- (void)testLayoutOfComponentWithoutMonotonicSizingIsOnlyReusedForSameSizeRange
+{
+  const auto leaf = [RCFixedSizeLeafComponent newWithView:{} size:{}];
+  const auto root = [RCCachingWrapperComponent newWithChild:leaf];
+
+  const auto first = RCComputeRootLayout(root, {{0, 0}, {375, INFINITY}}, RCLayoutCacheCreate(RCLayoutCacheBackendPersistentMap));
+  const auto same = RCComputeRootLayout(root, {{0, 0}, {375, INFINITY}}, first.cache);
+  const auto wider = RCComputeRootLayout(root, {{0, 0}, {414, INFINITY}}, same.cache);
+
+  XCTAssertEqual(leaf.layoutCount, 2);
+  XCTAssertEqual(RCLayoutCacheGetStatistics(*same.cache).exactHits, 1);
+  XCTAssertEqual(RCLayoutCacheGetStatistics(*wider.cache).subsumedHits, 0);
+}
+
+- (void)testEntriesAreOnlyCarriedOverForMountablesThatAreStillLaidOut
+{
+  for (const auto backend : {RCLayoutCacheBackendPersistentMap, RCLayoutCacheBackendFlatTable}) {
+    const auto removedLeaf = [RCFixedSizeLeafComponent newWithView:{} size:{}];
+    const auto leaf = [RCFixedSizeLeafComponent newWithView:{} size:{}];
+    const auto wrapper = [RCCachingWrapperComponent newWithChild:leaf];
+    const CKSizeRange sizeRange {{0, 0}, {375, INFINITY}};
+
+    const auto first = RCComputeRootLayout([RCCachingWrapperComponent newWithChild:removedLeaf], sizeRange, RCLayoutCacheCreate(backend));
+    const auto second = RCComputeRootLayout([RCCachingWrapperComponent newWithChild:wrapper], sizeRange, first.cache);
+    const auto third = RCComputeRootLayout([RCCachingWrapperComponent newWithChild:wrapper], sizeRange, second.cache);
+
+    XCTAssertTrue(RCLayoutCacheContainsEntryForMountable(*first.cache, removedLeaf));
+    XCTAssertFalse(RCLayoutCacheContainsEntryForMountable(*second.cache, removedLeaf));
+    XCTAssertEqual(RCLayoutCacheGetStatistics(*third.cache).exactHits, 1);
+    // The leaf is not looked up on the hit, but its entries are kept with the ones of its parent.
+    XCTAssertTrue(RCLayoutCacheContainsEntryForMountable(*third.cache, leaf));
+    XCTAssertEqual(leaf.layoutCount, 1);
+  }
+}
+
+
+- (void)testLayoutsOfChildrenMeasuredConcurrentlyAreCached
+{
+  for (const auto backend : {RCLayoutCacheBackendPersistentMap, RCLayoutCacheBackendFlatTable}) {
+    NSMutableArray<RCFixedSizeLeafComponent *> *leaves = [NSMutableArray array];
+    std::vector<CKFlexboxComponentChild> children;
+    for (int i = 0; i < 8; i++) {
+      const auto leaf = [RCFixedSizeLeafComponent newWithView:{} size:{}];
+      [leaves addObject:leaf];
+      children.push_back({.component = [RCCachingWrapperComponent newWithChild:leaf]});
+    }
+    const auto flexbox = [CKFlexboxComponent newWithView:{}
+                                                    size:{}
+                                                   style:{.measureChildrenConcurrently = YES}
+                                                children:std::move(children)];
+    const CKSizeRange sizeRange {{300, 0}, {300, INFINITY}};
+
+    const auto first = RCComputeRootLayout(flexbox, sizeRange, RCLayoutCacheCreate(backend));
+    const auto second = RCComputeRootLayout(flexbox, sizeRange, first.cache);
+
+    XCTAssertGreaterThanOrEqual(RCLayoutCacheGetStatistics(*first.cache).misses, leaves.count);
+    XCTAssertGreaterThanOrEqual(RCLayoutCacheGetStatistics(*second.cache).exactHits, leaves.count);
+    XCTAssertEqual(RCLayoutCacheGetStatistics(*second.cache).misses, 0);
+    for (RCFixedSizeLeafComponent *leaf in leaves) {
+      XCTAssertTrue(RCLayoutCacheContainsEntryForMountable(*second.cache, leaf));
+    }
+  }
+}
+
+@end
@@ -0,0 +1,56 @@
+/*
+*  Copyright (c) 2014-present, Facebook, Inc.
+*  All rights reserved.
+*
+*  This source code is licensed under the BSD-style license found in the
+*  LICENSE file in the root directory of this source tree. An additional grant
+*  of patent rights can be found in the PATENTS file in the same directory.
+*
+*/
+
+#import <XCTest/XCTest.h>
+
+#import <vector>
+
+#import <RenderCore/CKMountable.h>
+#import <RenderCoreLayoutCaching/RCLayoutCacheTable.h>
+
+@interface RCLayoutCacheTableTests : XCTestCase
+@end
+
+@implementation RCLayoutCacheTableTests
+
+- (void)test_FindsEntriesByMountableSizeRangeAndParentSize
+{
+  auto const m = (id<CKMountable>)[NSObject new];
+  const RCLayoutCacheKey key {CKSizeRange {{0, 0}, {100, INFINITY}}, {100, NAN}};
+  RCLayoutCacheTable table;
+  table.insert(m, key, RCLayout {});
+
+  XCTAssert(table.find(m, key) != nullptr);
+  XCTAssert(table.find(m, {key.constrainingSize, {100, 50}}) == nullptr);
+  XCTAssert(table.find(m, {CKSizeRange {{0, 0}, {200, INFINITY}}, key.parentSize}) == nullptr);
+  XCTAssert(table.find((id<CKMountable>)[NSObject new], key) == nullptr);
+}
+
+- (void)test_CopiesAllEntriesOfMountable
+{
+  std::vector<id<CKMountable>> mountables;
+  RCLayoutCacheTable table;
+  for (auto i = 0; i < 100; i++) {
+    mountables.push_back((id<CKMountable>)[NSObject new]);
+    for (auto j = 0; j < 3; j++) {
+      table.insert(mountables.back(), {CKSizeRange {{0, 0}, {CGFloat(j), CGFloat(j)}}, {0, 0}}, RCLayout {});
+    }
+  }
+
+  RCLayoutCacheTable next;
+  table.copyEntriesOfMountable(mountables[42], next);
+
+  XCTAssertEqual(table.size(), 300);
+  XCTAssertEqual(next.size(), 3);
+  XCTAssert(next.containsMountable(mountables[42]));
+  XCTAssertFalse(next.containsMountable(mountables[41]));
+}
+
+@end
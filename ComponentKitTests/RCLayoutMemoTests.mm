@@ -0,0 +1,248 @@
+/*
+ *  Copyright (c) 2014-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#import <XCTest/XCTest.h>
+
+#import <ComponentKit/CKComponent.h>
+#import <ComponentKit/CKComponentSubclass.h>
+#import <RenderCoreLayoutCaching/RCLayoutMemo.h>
+
+/** A content key whose hash is the same for every value. */
+@interface RCCollidingContentKey : NSObject
+@property (nonatomic, assign) NSUInteger value;
+@end
+
+@implementation RCCollidingContentKey
+- (NSUInteger)hash
+{
+  return 0;
+}
+
+- (BOOL)isEqual:(id)object
+{
+  return [object isKindOfClass:[RCCollidingContentKey class]] && ((RCCollidingContentKey *)object).value == _value;
+}
+@end
+
+/** A leaf whose layout only depends on its `content`. */
+@interface RCMemoizedBadgeComponent : CKComponent
+@property (nonatomic, assign) NSUInteger content;
+@property (nonatomic, assign) BOOL usesCollidingContentKey;
+@property (nonatomic, assign) NSUInteger layoutCount;
+@end
+
+@implementation RCMemoizedBadgeComponent
++ (BOOL)hasLayoutContentKey
+{
+  return YES;
+}
+
+- (id<NSObject>)layoutContentKey
+{
+  if (_usesCollidingContentKey) {
+    RCCollidingContentKey *const key = [RCCollidingContentKey new];
+    key.value = _content;
+    return key;
+  }
+  return @(_content);
+}
+
+- (RCLayout)computeLayoutThatFits:(CKSizeRange)constrainedSize
+{
+  _layoutCount++;
+  return {self, constrainedSize.clamp({CGFloat(10 * _content), 20})};
+}
+@end
+
+/** Lays its badges out in a row. */
+@interface RCMemoizedRowComponent : CKComponent
++ (instancetype)newWithBadges:(NSArray<RCMemoizedBadgeComponent *> *)badges;
+@property (nonatomic, assign) NSUInteger layoutCount;
+@end
+
+@implementation RCMemoizedRowComponent
+{
+  NSArray<RCMemoizedBadgeComponent *> *_badges;
+}
+
++ (instancetype)newWithBadges:(NSArray<RCMemoizedBadgeComponent *> *)badges
+{
+  const auto c = [super newWithView:{} size:{}];
+  if (c) {
+    c->_badges = badges;
+  }
+  return c;
+}
+
++ (BOOL)hasLayoutContentKey
+{
+  return YES;
+}
+
+- (id<NSObject>)layoutContentKey
+{
+  NSMutableArray<id<NSObject>> *const key = [NSMutableArray array];
+  for (RCMemoizedBadgeComponent *badge in _badges) {
+    [key addObject:[badge layoutContentKey]];
+  }
+  return [key copy];
+}
+
+- (RCLayout)computeLayoutThatFits:(CKSizeRange)constrainedSize
+{
+  _layoutCount++;
+  std::vector<RCLayoutChild> children;
+  CGFloat x = 0;
+  for (RCMemoizedBadgeComponent *badge in _badges) {
+    const RCLayout layout = [badge layoutThatFits:{{0, 0}, {INFINITY, 20}} parentSize:{NAN, 20}];
+    children.push_back({{x, 0}, layout});
+    x += layout.size.width;
+  }
+  return {self, constrainedSize.clamp({x, 20}), std::move(children)};
+}
+
+- (unsigned int)numberOfChildren
+{
+  return (unsigned int)_badges.count;
+}
+
+- (id<CKMountable>)childAtIndex:(unsigned int)index
+{
+  return index < _badges.count ? _badges[index] : nil;
+}
+@end
+
+@interface RCLayoutMemoTests : XCTestCase
+@end
+
+@implementation RCLayoutMemoTests
+
+- (void)setUp
+{
+  [super setUp];
+  RCLayoutMemoClear();
+  RCLayoutMemoSetByteBudget(1024 * 1024);
+}
+
+- (void)tearDown
+{
+  RCLayoutMemoSetByteBudget(0);
+  RCLayoutMemoClear();
+  [super tearDown];
+}
+
+static RCMemoizedBadgeComponent *badge(NSUInteger content)
+{
+  const auto c = [RCMemoizedBadgeComponent newWithView:{} size:{}];
+  c.content = content;
+  return c;
+}
+
+- (void)testLayoutIsReusedByAnotherComponentWithSameContent
+{
+  const auto first = badge(3);
+  const auto second = badge(3);
+
+  const auto firstLayout = [first layoutThatFits:{{0, 0}, {375, INFINITY}} parentSize:{375, NAN}];
+  const auto secondLayout = [second layoutThatFits:{{0, 0}, {375, INFINITY}} parentSize:{375, NAN}];
+
+  XCTAssertEqual(first.layoutCount, 1);
+  XCTAssertEqual(second.layoutCount, 0);
+  XCTAssertEqual(secondLayout.component, second);
+  XCTAssertTrue(CGSizeEqualToSize(secondLayout.size, firstLayout.size));
+  XCTAssertEqual(RCLayoutMemoGetStatistics().hits, 1);
+}
+
+- (void)testLayoutIsNotReusedForDifferentContent
+{
+  const auto first = badge(3);
+  const auto second = badge(4);
+
+  [first layoutThatFits:{{0, 0}, {375, INFINITY}} parentSize:{375, NAN}];
+  [second layoutThatFits:{{0, 0}, {375, INFINITY}} parentSize:{375, NAN}];
+
+  XCTAssertEqual(second.layoutCount, 1);
+  XCTAssertEqual(RCLayoutMemoGetStatistics().misses, 2);
+}
+
+- (void)testLayoutIsNotReusedForDifferentContentWithSameHash
+{
+  const auto first = badge(3);
+  const auto second = badge(4);
+  first.usesCollidingContentKey = YES;
+  second.usesCollidingContentKey = YES;
+
+  [first layoutThatFits:{{0, 0}, {375, INFINITY}} parentSize:{375, NAN}];
+  const auto secondLayout = [second layoutThatFits:{{0, 0}, {375, INFINITY}} parentSize:{375, NAN}];
+
+  XCTAssertEqual(second.layoutCount, 1);
+  XCTAssertTrue(CGSizeEqualToSize(secondLayout.size, CGSizeMake(40, 20)));
+  XCTAssertEqual(RCLayoutMemoGetStatistics().hits, 0);
+}
+
+- (void)testMemoizedLayoutIsBoundToTheChildrenOfAnotherComponentWithSameContent
+{
+  NSArray<RCMemoizedBadgeComponent *> *const firstBadges = @[badge(1), badge(2)];
+  NSArray<RCMemoizedBadgeComponent *> *const secondBadges = @[badge(1), badge(2)];
+  const auto first = [RCMemoizedRowComponent newWithBadges:firstBadges];
+  const auto second = [RCMemoizedRowComponent newWithBadges:secondBadges];
+
+  const auto firstLayout = [first layoutThatFits:{{0, 0}, {375, INFINITY}} parentSize:{375, NAN}];
+  const auto secondLayout = [second layoutThatFits:{{0, 0}, {375, INFINITY}} parentSize:{375, NAN}];
+
+  XCTAssertEqual(second.layoutCount, 0);
+  XCTAssertEqual(secondLayout.component, second);
+  XCTAssertTrue(CGSizeEqualToSize(secondLayout.size, firstLayout.size));
+  XCTAssertEqual(secondLayout.children->size(), 2u);
+  for (NSUInteger i = 0; i < secondBadges.count; i++) {
+    const auto &firstChild = (*firstLayout.children)[i];
+    const auto &secondChild = (*secondLayout.children)[i];
+    // The badges of the second row are bound to the memoized layout without being laid out.
+    XCTAssertEqual(secondChild.layout.component, secondBadges[i]);
+    XCTAssertEqual(secondBadges[i].layoutCount, 0);
+    XCTAssertTrue(CGPointEqualToPoint(secondChild.position, firstChild.position));
+    XCTAssertTrue(CGSizeEqualToSize(secondChild.layout.size, firstChild.layout.size));
+  }
+}
+
+- (void)testByteCountIncludesTheContentKey
+{
+  [badge(1) layoutThatFits:{{0, 0}, {375, INFINITY}} parentSize:{375, NAN}];
+  const auto byteCountWithTaggedKey = RCLayoutMemoGetStatistics().byteCount;
+  RCLayoutMemoClear();
+
+  const auto withAllocatedKey = badge(1);
+  withAllocatedKey.usesCollidingContentKey = YES;
+  [withAllocatedKey layoutThatFits:{{0, 0}, {375, INFINITY}} parentSize:{375, NAN}];
+
+  XCTAssertGreaterThan(RCLayoutMemoGetStatistics().byteCount, byteCountWithTaggedKey);
+}
+
+- (void)testLeastRecentlyUsedEntriesAreEvictedToStayWithinBudget
+{
+  [badge(1) layoutThatFits:{{0, 0}, {375, INFINITY}} parentSize:{375, NAN}];
+  const auto entryByteCount = RCLayoutMemoGetStatistics().byteCount;
+  RCLayoutMemoSetByteBudget(2 * entryByteCount);
+
+  [badge(2) layoutThatFits:{{0, 0}, {375, INFINITY}} parentSize:{375, NAN}];
+  [badge(1) layoutThatFits:{{0, 0}, {375, INFINITY}} parentSize:{375, NAN}];
+  [badge(3) layoutThatFits:{{0, 0}, {375, INFINITY}} parentSize:{375, NAN}];
+
+  const auto stillMemoized = badge(1);
+  const auto evicted = badge(2);
+  [stillMemoized layoutThatFits:{{0, 0}, {375, INFINITY}} parentSize:{375, NAN}];
+  [evicted layoutThatFits:{{0, 0}, {375, INFINITY}} parentSize:{375, NAN}];
+
+  XCTAssertEqual(stillMemoized.layoutCount, 0);
+  XCTAssertEqual(evicted.layoutCount, 1);
+  XCTAssertLessThanOrEqual(RCLayoutMemoGetStatistics().byteCount, 2 * entryByteCount);
+}
+
+@end
@@ -0,0 +1,100 @@
+/*
+*  Copyright (c) 2014-present, Facebook, Inc.
+*  All rights reserved.
+*
+*  This source code is licensed under the BSD-style license found in the
+*  LICENSE file in the root directory of this source tree. An additional grant
+*  of patent rights can be found in the PATENTS file in the same directory.
+*
+*/
+
+#import <XCTest/XCTest.h>
+
+#include <unordered_map>
+
+#import <ComponentKit/RCPersistentMap.h>
+
+@interface RCPersistentMapTests : XCTestCase
+@end
+
+/** Forces every key into a handful of hash buckets, to exercise collisions. */
+struct CollidingHash {
+  size_t operator()(int x) const { return x % 3; }
+};
+
+@implementation RCPersistentMapTests
+
+- (void)test_Empty
+{
+  auto const m = RC::PersistentMap<int, int>{};
+
+  XCTAssert(m.empty());
+  XCTAssert(m.find(0) == nullptr);
+}
+
+- (void)test_InsertDoesNotModifyPreviousVersion
+{
+  auto const m1 = RC::PersistentMap<int, int>{}.insert(1, 10);
+  auto const m2 = m1.insert(2, 20).insert(1, 11);
+
+  XCTAssertEqual(m1.size(), 1);
+  XCTAssertEqual(*m1.find(1), 10);
+  XCTAssert(m1.find(2) == nullptr);
+  XCTAssertEqual(m2.size(), 2);
+  XCTAssertEqual(*m2.find(1), 11);
+  XCTAssertEqual(*m2.find(2), 20);
+}
+
+- (void)test_EraseDoesNotModifyPreviousVersion
+{
+  auto const m1 = RC::PersistentMap<int, int>{}.insert(1, 10).insert(2, 20);
+  auto const m2 = m1.erase(1);
+
+  XCTAssertEqual(m1.size(), 2);
+  XCTAssertEqual(*m1.find(1), 10);
+  XCTAssertEqual(m2.size(), 1);
+  XCTAssert(m2.find(1) == nullptr);
+  XCTAssertEqual(m2.erase(3).size(), 1);
+}
+
+- (void)test_InsertInPlaceDoesNotModifySharedVersions
+{
+  auto m1 = RC::PersistentMap<int, int, CollidingHash>{};
+  for (int i = 0; i < 100; i++) {
+    m1.insertInPlace(i, i);
+  }
+  auto m2 = m1;
+  m2.insertInPlace(1, 11);
+  m2.insertInPlace(100, 100);
+
+  XCTAssertEqual(m1.size(), 100);
+  XCTAssertEqual(*m1.find(1), 1);
+  XCTAssert(m1.find(100) == nullptr);
+  XCTAssertEqual(m2.size(), 101);
+  XCTAssertEqual(*m2.find(1), 11);
+  XCTAssertEqual(*m2.find(100), 100);
+}
+
+- (void)test_MatchesUnorderedMapWithCollidingHashes
+{
+  auto m = RC::PersistentMap<int, int, CollidingHash>{};
+  auto expected = std::unordered_map<int, int>{};
+  for (int i = 0; i < 1000; i++) {
+    m = m.insert(i, i * 2);
+    expected[i] = i * 2;
+  }
+  for (int i = 0; i < 1000; i += 3) {
+    m = m.erase(i);
+    expected.erase(i);
+  }
+
+  XCTAssertEqual(m.size(), expected.size());
+  size_t count = 0;
+  m.forEach([&](int key, int value) {
+    XCTAssertEqual(expected[key], value);
+    count++;
+  });
+  XCTAssertEqual(count, expected.size());
+}
+
+@end
@@ -837,6 +837,36 @@ static BOOL testComponentControllerProtocolPredicate(id<CKComponentControllerPro
   XCTAssert([root componentsMatchingPredicate:&testComponentProtocolPredicate].empty(), @"Should not have found any components");
 }
 
+static NSUInteger classPurePredicateCallCount = 0;
+
+static BOOL testClassPureComponentProtocolPredicate(id<CKComponentProtocol> component)
+{
+  classPurePredicateCallCount++;
+  return [component conformsToProtocol:@protocol(TestScopedProtocol)];
+}
+
+- (void)testComponentScopeRootEvaluatesClassPurePredicateOncePerClassAcrossGenerations
+{
+  CKComponentPredicateDeclareClassPure(&testClassPureComponentProtocolPredicate);
+  classPurePredicateCallCount = 0;
+  const auto root = makeScopeRootWithComponentPredicate(&testClassPureComponentProtocolPredicate);
+  const auto c1 = [TestComponentWithScopedProtocol new];
+  const auto c2 = [TestComponentWithScopedProtocol new];
+  const auto c3 = [TestComponentWithoutScopedProtocol new];
+  const auto c4 = [TestComponentWithoutScopedProtocol new];
+
+  [root registerComponent:c1];
+  [root registerComponent:c2];
+  [root registerComponent:c3];
+  const auto newRoot = [root newRoot];
+  [newRoot registerComponent:c4];
+  [newRoot registerComponent:c1];
+
+  XCTAssertEqual(classPurePredicateCallCount, 2);
+  XCTAssertEqual([root componentsMatchingPredicate:&testClassPureComponentProtocolPredicate].size(), 2);
+  XCTAssert([newRoot componentsMatchingPredicate:&testClassPureComponentProtocolPredicate] == std::vector<id<CKComponentProtocol>>{c1});
+}
+
 static auto makeScopeRootWithComponentPredicate(const CKComponentPredicate p) -> CKComponentScopeRoot *
 {
   return [CKComponentScopeRoot
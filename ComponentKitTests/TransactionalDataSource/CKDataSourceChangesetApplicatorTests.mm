@@ -348,6 +348,11 @@ inComponentTreeWithRootComponent:(id<CKMountable>)component
 
 }
 
+- (void)didProcessLayoutOfComponentTreeWithRootComponent:(id<CKMountable>)component duration:(CFTimeInterval)duration
+{
+
+}
+
 - (void)didMountComponentTreeWithRootComponent:(id<CKMountable>)component
                          mountAnalyticsContext:(CK::Optional<CK::Component::MountAnalyticsContext>)mountAnalyticsContext
 {
@@ -397,6 +402,11 @@ fromPreviousScopeRoot:(CKComponentScopeRoot *)previousScopeRoot
 - (void)didReceiveStateUpdateFromScopeHandle:(CKComponentScopeHandle *)handle rootIdentifier:(CKComponentScopeRootIdentifier)rootID {
 }
 
+- (void)didCoalesceStateUpdates:(NSUInteger)stateUpdateCount
+                       withMode:(CKUpdateMode)mode
+                 rootIdentifier:(CKComponentScopeRootIdentifier)rootID {
+}
+
 
 #pragma mark - Helpers
 
@@ -21,7 +21,9 @@
 #import <ComponentKit/CKDataSourceChangeset.h>
 #import <ComponentKit/CKDataSourceItem.h>
 #import <ComponentKit/CKDataSourceChangesetModification.h>
+#import <ComponentKit/CKDataSourceConfigurationInternal.h>
 #import <ComponentKit/CKDataSourceState.h>
+#import <ComponentKit/CKDataSourceStateInternal.h>
 #import <ComponentKitTestHelpers/CKLifecycleTestComponent.h>
 #import <ComponentKitTestHelpers/NSIndexSetExtensions.h>
 
@@ -275,6 +277,56 @@ static CKComponent *ComponentProvider(id<NSObject> model, id<NSObject>)
   XCTAssertEqualObjects(c1.model, @0);
 }
 
+- (void)testBuildingItemsConcurrently_InsertsAndUpdatesItemsInIndexOrder
+{
+  CKDataSourceOptions options;
+  options.itemBuildOptions.maxConcurrentBuildsUserInitiated = 4;
+  CKDataSourceConfiguration *const configuration =
+  [[CKDataSourceConfiguration alloc] initWithComponentProviderFunc:ComponentProvider
+                                                           context:nil
+                                                         sizeRange:{{100, 100}, {100, 100}}
+                                                           options:options
+                                               componentPredicates:{}
+                                     componentControllerPredicates:{}
+                                                 analyticsListener:nil];
+  CKDataSourceState *const emptyState = [[CKDataSourceState alloc] initWithConfiguration:configuration sections:@[]];
+
+  const auto insertedItems = [NSMutableDictionary<NSIndexPath *, id> dictionary];
+  for (NSUInteger i = 0; i < 50; i++) {
+    insertedItems[[NSIndexPath indexPathForItem:i inSection:0]] = @(i);
+  }
+  CKDataSourceChangeset *const insertion =
+  [[[[CKDataSourceChangesetBuilder dataSourceChangeset]
+     withInsertedSections:[NSIndexSet indexSetWithIndex:0]]
+    withInsertedItems:insertedItems]
+   build];
+  CKDataSourceState *const state =
+  [[[CKDataSourceChangesetModification alloc] initWithChangeset:insertion
+                                                  stateListener:nil
+                                                       userInfo:nil
+                                                            qos:CKDataSourceQOSUserInitiated] changeFromState:emptyState].state;
+
+  const auto updatedItems = [NSMutableDictionary<NSIndexPath *, id> dictionary];
+  for (NSUInteger i = 0; i < 50; i += 2) {
+    updatedItems[[NSIndexPath indexPathForItem:i inSection:0]] = @(i + 100);
+  }
+  CKDataSourceChangeset *const update =
+  [[[CKDataSourceChangesetBuilder dataSourceChangeset]
+    withUpdatedItems:updatedItems]
+   build];
+  CKDataSourceState *const updatedState =
+  [[[CKDataSourceChangesetModification alloc] initWithChangeset:update
+                                                  stateListener:nil
+                                                       userInfo:nil
+                                                            qos:CKDataSourceQOSUserInitiated] changeFromState:state].state;
+
+  XCTAssertEqual([updatedState numberOfObjectsInSection:0], (NSUInteger)50);
+  for (NSUInteger i = 0; i < 50; i++) {
+    auto c = (CKModelExposingComponent *)[[updatedState objectAtIndexPath:[NSIndexPath indexPathForItem:i inSection:0]] rootLayout].component();
+    XCTAssertEqualObjects(c.model, @(i % 2 == 0 ? i + 100 : i));
+  }
+}
+
 @end
 
 // Based on https://developer.apple.com/documentation/foundation/nsmutablearray/1416482-insertobjects?language=objc
@@ -110,6 +110,39 @@ Unmounts the component:
 /** Name of the component's class */
 @property (nonatomic, copy, readonly) NSString *className;
 
+/**
+ Return YES if the layout of this component is fully determined by the size it picks: for any size range that contains
+ the size of a layout it computed before, it would compute that same layout again. The parent size may only matter
+ through the size of the component, see -sizeIsRelativeToParentSize.
+
+ When layout caching is enabled, this lets a cached layout be reused for a new size range that contains its size, such
+ as a leaf measured at 120pt wide under a maximum width of 375pt and then laid out under a maximum width of 414pt.
+ */
+@property (nonatomic, assign, readonly, class) BOOL hasMonotonicSizing;
+
+/**
+ Return YES if the size of this component is a percentage of its parent size in any dimension. Cached layouts of
+ components with monotonic sizing are then only reused under the same parent size.
+ */
+@property (nonatomic, assign, readonly) BOOL sizeIsRelativeToParentSize;
+
+/**
+ Return YES to have the layouts of this class memoized by content, see RCFetchOrComputeMemoizedLayout. Layouts are then
+ shared between all the components of this class whose -layoutContentKey are equal.
+
+ A memoized layout is reused without laying out the descendants of the component, so they must not rely on being laid
+ out, e.g. to observe layout or to fill a layout cache.
+ */
+@property (nonatomic, assign, readonly, class) BOOL hasLayoutContentKey;
+
+/**
+ Only called if +hasLayoutContentKey returns YES. Must capture everything the layout depends on, other than the size
+ range and parent size: the layout-relevant props of the component and those of all its descendants. Keys are compared
+ with -isEqual: and hashed with -hash, possibly from several threads, so they must be immutable. Return nil to not
+ memoize the layout of this component.
+ */
+- (id<NSObject>)layoutContentKey;
+
 @end
 
 #else
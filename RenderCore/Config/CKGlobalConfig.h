@@ -61,6 +61,37 @@ struct CKGlobalConfig {
    Enables caching of the layout for reused components.
    */
   BOOL enableLayoutCaching = NO;
+  /**
+   Stores the layout cache of each tree in a flat open-addressing table instead of a persistent map.
+   Only has an effect when `enableLayoutCaching` is enabled.
+   */
+  BOOL enableFlatLayoutCacheTable = NO;
+  /**
+   Byte budget of the global layout memo table used by components that return YES from +hasLayoutContentKey, keyed by
+   their -layoutContentKey. See RCFetchOrComputeMemoizedLayout. 0 disables the memo table.
+   */
+  NSUInteger layoutMemoByteBudget = 0;
+  /**
+   Skips mounting subtrees whose layout did not change since the previous mount in the same root view.
+   See RCIncrementalMountState.
+   */
+  BOOL enableIncrementalMount = NO;
+  /**
+   Lays out plain flexbox stacks, whose children are neither flexible nor sized by the flexbox, without building a Yoga
+   tree. The layout is meant to be the same as Yoga's, see -[CKFlexboxComponent computeStackLayoutThatFits:].
+   */
+  BOOL enableFlexboxStackLayout = NO;
+  /**
+   Lays out all flexbox components as if their style set useDeepYogaTrees, so that nested flexbox, inset and background
+   layout components are laid out in a single Yoga calculation.
+   */
+  BOOL useDeepYogaTrees = NO;
+  /**
+   Builds the component trees of sibling render components concurrently when a component has several of them, on forks
+   of the scope root and tree nodes that are merged back in order. Analytics listeners are then called from several
+   threads. See CKBuildComponent.
+   */
+  BOOL buildRenderChildrenConcurrently = NO;
   /**
    In Specs we provide a custom identifier, which is a function pointer to the
    handler function. This bool enables using this identifier in == operator
@@ -78,6 +78,9 @@ struct RCComponentSize {
    */
   CKSizeRange resolve(const CGSize &parentSize) const noexcept;
 
+  /** Returns true if any of the dimensions is a percentage of the parent size. */
+  bool isRelativeToParentSize() const noexcept;
+
   bool operator==(const RCComponentSize &other) const noexcept;
   NSString *description() const noexcept;
 };
@@ -65,6 +65,16 @@ CKSizeRange RCComponentSize::resolve(const CGSize &parentSize) const noexcept
   return {rangeMin, rangeMax};
 }
 
+bool RCComponentSize::isRelativeToParentSize() const noexcept
+{
+  for (const auto &dimension : {width, height, minWidth, minHeight, maxWidth, maxHeight}) {
+    if (dimension.type() == RCRelativeDimension::Type::PERCENT) {
+      return true;
+    }
+  }
+  return false;
+}
+
 bool RCComponentSize::operator==(const RCComponentSize &other) const noexcept
 {
   return width == other.width && height == other.height
@@ -12,6 +12,8 @@
 
 #if CK_NOT_SWIFT
 
+#import <memory>
+#import <unordered_map>
 #import <utility>
 #import <vector>
 
@@ -65,6 +67,36 @@ struct RCLayoutChild {
 
 @end
 
+/**
+ Opt-in state that lets CKMountLayout skip subtrees whose layout did not change since the previous mount.
+
+ A subtree is skipped when its root component owns a view, is still mounted in the same view, and its layout shares the
+ exact same `children` vector as the last time it was mounted (which is what happens when layouts are reused through the
+ layout cache). The root component itself is always mounted again so that its view keeps its place in the parent's view
+ reuse pool; its descendants are neither mounted again nor reported to the CKMountLayoutListener.
+
+ Keep one instance per root view and pass it to every call to CKMountLayout for that view.
+ */
+struct RCIncrementalMountState {
+  struct MountedSubtree {
+    id<CKMountable> component;
+    std::shared_ptr<const std::vector<RCLayoutChild>> children;
+    UIView *view;
+    UIEdgeInsets layoutGuide;
+    /**
+     Descendants of `component`, in mount order, are `mountOrder[begin, end)`. When a subtree is skipped, the entries of its
+     descendants are moved over to the new mount order so that older ones are not kept alive.
+     */
+    std::shared_ptr<const std::vector<id<CKMountable>>> mountOrder;
+    size_t begin;
+    size_t end;
+  };
+
+  std::unordered_map<const void *, MountedSubtree> mountedSubtrees;
+  /** Number of component mounts skipped by the last call to CKMountLayout. */
+  NSUInteger skippedComponentCount = 0;
+};
+
 /**
  Recursively mounts the layout in the view, returning a set of the mounted components.
  @param layout The layout to mount, usually returned from a call to -layoutThatFits:parentSize:
@@ -75,13 +107,59 @@ struct RCLayoutChild {
         component responder chain can be connected correctly.
  @param mountAnalyticsContext If non-null, the counters in this context will be incremented during mount.
  @param listener Object collecting all mount layout events. Can be nil.
+ @param incrementalMountState If non-null, subtrees that did not change since the previous mount using the same state are
+        skipped. See RCIncrementalMountState.
  */
 NSSet<id<CKMountable>> *CKMountLayout(const RCLayout &layout,
                                       UIView *view,
                                       NSSet<id<CKMountable>> *previouslyMountedComponents,
                                       id<CKMountable> supercomponent,
                                       CK::Component::MountAnalyticsContext *mountAnalyticsContext,
-                                      id<CKMountLayoutListener> listener);
+                                      id<CKMountLayoutListener> listener,
+                                      RCIncrementalMountState *incrementalMountState = nullptr);
+
+/**
+ A mount of a layout that can be spread over several runloop turns.
+
+ Components are mounted in exactly the same DFS order as CKMountLayout, and the listener receives the same callbacks.
+ Each call to mountUntil() mounts components until the deadline is reached, then returns so that the caller can yield
+ and call it again later (usually on the next runloop turn). Components in `previouslyMountedComponents` that are not part
+ of the new layout are only unmounted once the whole tree has been mounted.
+
+ If a resumable mount is abandoned before it finishes, the components it already mounted are part of the view hierarchy:
+ pass the union of `previouslyMountedComponents` and mountedComponents() as the previously mounted components of the next
+ mount in the same view.
+ */
+class RCResumableLayoutMount {
+public:
+  RCResumableLayoutMount(const RCLayout &layout,
+                         UIView *view,
+                         NSSet<id<CKMountable>> *previouslyMountedComponents,
+                         id<CKMountable> supercomponent,
+                         CK::Component::MountAnalyticsContext *mountAnalyticsContext,
+                         id<CKMountLayoutListener> listener,
+                         RCIncrementalMountState *incrementalMountState = nullptr);
+  ~RCResumableLayoutMount();
+
+  /**
+   Mounts components until `deadline` (compared against CACurrentMediaTime()) is reached or the whole layout is mounted.
+   At least one component is mounted per call, even if the deadline already passed. Pass INFINITY to mount in one go.
+   @return true if the whole layout has been mounted.
+   */
+  bool mountUntil(CFTimeInterval deadline);
+
+  bool isFinished() const noexcept;
+
+  /** The components mounted so far; once finished, this is the same set CKMountLayout would return. */
+  NSSet<id<CKMountable>> *mountedComponents() const noexcept;
+
+private:
+  struct State;
+  std::unique_ptr<State> _state;
+
+  RCResumableLayoutMount(const RCResumableLayoutMount &) = delete;
+  RCResumableLayoutMount &operator=(const RCResumableLayoutMount &) = delete;
+};
 
 /** Unmounts all components returned by a previous call to CKMountComponentLayout. */
 void CKUnmountComponents(NSSet<id<CKMountable>> *componentsToUnmount);
@@ -84,45 +84,176 @@ std::shared_ptr<const std::vector<RCLayoutChild>> RCLayout::emptyChildren() noex
   return cached;
 }
 
-NSSet<id<CKMountable>> *CKMountLayout(const RCLayout &layout,
-                                      UIView *view,
-                                      NSSet<id<CKMountable>> *previouslyMountedComponents,
-                                      id<CKMountable> supercomponent,
-                                      CK::Component::MountAnalyticsContext *mountAnalyticsContext,
-                                      id<CKMountLayoutListener> listener)
-{
+struct RCResumableLayoutMount::State {
   struct MountItem {
     const RCLayout &layout;
     MountContext mountContext;
     id<CKMountable> supercomponent;
     BOOL visited;
+    /** Index in mountOrder of the first descendant of this item, only used for incremental mounts. */
+    size_t mountOrderBegin;
+    /** The view the children of this item are mounted in, if the item owns one. Only used for incremental mounts. */
+    UIView *childrenView;
+    UIEdgeInsets childrenLayoutGuide;
   };
 
+  /** Keeps the whole layout tree alive while the mount is suspended, since mount items reference it. */
+  const RCLayout root;
+  NSSet<id<CKMountable>> *previouslyMountedComponents;
+  CK::Component::MountAnalyticsContext *mountAnalyticsContext;
+  id<CKMountLayoutListener> listener;
+  RCIncrementalMountState *incrementalMountState;
+
   // Using a stack to mount ensures that the components are mounted
   // in a DFS fashion which is handy if you want to animate a subpart
   // of the tree
   std::stack<MountItem> stack;
-  stack.push({layout, MountContext::RootContext(view, mountAnalyticsContext), supercomponent, NO});
-  auto const mountedComponents = CK::makeNonNull([NSMutableSet set]);
+  NSMutableSet<id<CKMountable>> *mountedComponents;
+  // Components in mount order, so that the descendants of a subtree can be found again if it is skipped on the next mount.
+  std::shared_ptr<std::vector<id<CKMountable>>> mountOrder;
+  bool finished;
+};
+
+RCResumableLayoutMount::RCResumableLayoutMount(const RCLayout &layout,
+                                               UIView *view,
+                                               NSSet<id<CKMountable>> *previouslyMountedComponents,
+                                               id<CKMountable> supercomponent,
+                                               CK::Component::MountAnalyticsContext *mountAnalyticsContext,
+                                               id<CKMountLayoutListener> listener,
+                                               RCIncrementalMountState *incrementalMountState)
+: _state(new State {
+  layout,
+  previouslyMountedComponents,
+  mountAnalyticsContext,
+  listener,
+  incrementalMountState,
+  {},
+  [NSMutableSet set],
+  incrementalMountState ? std::make_shared<std::vector<id<CKMountable>>>() : nullptr,
+  false,
+})
+{
+  _state->stack.push({_state->root, MountContext::RootContext(view, mountAnalyticsContext), supercomponent, NO});
+  if (incrementalMountState) {
+    incrementalMountState->skippedComponentCount = 0;
+  }
+}
+
+RCResumableLayoutMount::~RCResumableLayoutMount() = default;
+
+bool RCResumableLayoutMount::isFinished() const noexcept
+{
+  return _state->finished;
+}
+
+NSSet<id<CKMountable>> *RCResumableLayoutMount::mountedComponents() const noexcept
+{
+  return _state->mountedComponents;
+}
+
+bool RCResumableLayoutMount::mountUntil(CFTimeInterval deadline)
+{
+  auto &stack = _state->stack;
+  auto const mountedComponents = _state->mountedComponents;
+  auto const &mountOrder = _state->mountOrder;
+  auto const incrementalMountState = _state->incrementalMountState;
+  auto const mountAnalyticsContext = _state->mountAnalyticsContext;
+  id<CKMountLayoutListener> const listener = _state->listener;
+  NSSet<id<CKMountable>> *const previouslyMountedComponents = _state->previouslyMountedComponents;
+  // Reading the clock is not free, don't do it when mounting in one go.
+  const bool hasDeadline = deadline != INFINITY;
+  // Always make progress, even if the deadline already passed when we were called.
+  bool didMountComponent = false;
 
   while (!stack.empty()) {
-    MountItem &item = stack.top();
+    State::MountItem &item = stack.top();
     if (item.visited) {
       if (auto const c = item.layout.component) {
         [c childrenDidMount];
         [listener didMountComponent:c];
+        if (incrementalMountState) {
+          const auto key = (__bridge const void *)c;
+          if (item.childrenView) {
+            incrementalMountState->mountedSubtrees[key] = {
+              c,
+              item.layout.children,
+              item.childrenView,
+              item.childrenLayoutGuide,
+              mountOrder,
+              item.mountOrderBegin,
+              mountOrder->size(),
+            };
+          } else {
+            incrementalMountState->mountedSubtrees.erase(key);
+          }
+        }
       }
       stack.pop();
     } else {
-      item.visited = YES;
       if (item.layout.component == nil) {
+        item.visited = YES;
         continue; // Nil components in a layout struct are invalid, but handle them gracefully
       }
-      [listener willMountComponent:item.layout.component];
-      const MountResult mountResult = [item.layout.component mountInContext:item.mountContext
-                                                                     layout:item.layout
-                                                             supercomponent:item.supercomponent];
-      [mountedComponents addObject:item.layout.component];
+      if (hasDeadline && didMountComponent && CACurrentMediaTime() >= deadline) {
+        // Budget spent: yield before mounting the next component, the traversal resumes from here.
+        return false;
+      }
+      item.visited = YES;
+      didMountComponent = true;
+      id<CKMountable> const component = item.layout.component;
+      UIView *const previouslyMountedView = incrementalMountState ? component.mountedView : nil;
+      [listener willMountComponent:component];
+      const MountResult mountResult = [component mountInContext:item.mountContext
+                                                         layout:item.layout
+                                                 supercomponent:item.supercomponent];
+      [mountedComponents addObject:component];
+
+      if (incrementalMountState) {
+        mountOrder->push_back(component);
+        item.mountOrderBegin = mountOrder->size();
+        if (mountResult.mountChildren && mountResult.contextForChildren.viewManager != item.mountContext.viewManager) {
+          item.childrenView = mountResult.contextForChildren.viewManager->view;
+          item.childrenLayoutGuide = mountResult.contextForChildren.layoutGuide;
+        }
+      }
+
+      if (incrementalMountState && item.childrenView) {
+        const auto it = incrementalMountState->mountedSubtrees.find((__bridge const void *)component);
+        if (it != incrementalMountState->mountedSubtrees.end()
+            && it->second.children == item.layout.children
+            && it->second.view == item.childrenView
+            && previouslyMountedView == item.childrenView
+            && UIEdgeInsetsEqualToEdgeInsets(it->second.layoutGuide, item.childrenLayoutGuide)
+            && [previouslyMountedComponents containsObject:component]) {
+          // Nothing below this component changed: its descendants are still mounted in its view exactly as they were.
+          // The descendants' entries are moved over to this pass's mount order too, so that the previous one (which holds
+          // on to components that may have been unmounted since) can be released.
+          const auto previousMountOrder = it->second.mountOrder;
+          const auto previousBegin = it->second.begin;
+          const auto previousEnd = it->second.end;
+          const auto newBegin = mountOrder->size();
+          for (size_t i = previousBegin; i < previousEnd; i++) {
+            id<CKMountable> const descendant = (*previousMountOrder)[i];
+            [mountedComponents addObject:descendant];
+            mountOrder->push_back(descendant);
+            const auto descendantIt = incrementalMountState->mountedSubtrees.find((__bridge const void *)descendant);
+            if (descendantIt != incrementalMountState->mountedSubtrees.end()
+                && descendantIt->second.mountOrder == previousMountOrder) {
+              auto &subtree = descendantIt->second;
+              subtree.mountOrder = mountOrder;
+              subtree.begin = subtree.begin - previousBegin + newBegin;
+              subtree.end = subtree.end - previousBegin + newBegin;
+            }
+          }
+          const auto skipped = previousEnd - previousBegin;
+          incrementalMountState->skippedComponentCount += skipped;
+          if (mountAnalyticsContext) {
+            mountAnalyticsContext->skippedComponentMounts += skipped;
+          }
+          mountResult.contextForChildren.viewManager->keepPreviousMount();
+          continue;
+        }
+      }
 
       if (mountResult.mountChildren) {
         // Ordering of components should correspond to ordering of mount. Push components on backwards so the
@@ -134,13 +265,41 @@ NSSet<id<CKMountable>> *CKMountLayout(const RCLayout &layout,
     }
   }
 
-  // Unmount any components that were in previouslyMountedComponents but are no longer in mountedComponents.
-  for (id<CKMountable> component in previouslyMountedComponents) {
-    if (![mountedComponents containsObject:component]) {
-      [component unmount];
+  if (!_state->finished) {
+    _state->finished = true;
+    // Unmount any components that were in previouslyMountedComponents but are no longer in mountedComponents.
+    // This only happens once the whole tree is mounted, so nothing disappears from screen while the mount is suspended.
+    for (id<CKMountable> component in previouslyMountedComponents) {
+      if (![mountedComponents containsObject:component]) {
+        [component unmount];
+        if (incrementalMountState) {
+          incrementalMountState->mountedSubtrees.erase((__bridge const void *)component);
+        }
+      }
     }
   }
-  return mountedComponents;
+  return true;
+}
+
+NSSet<id<CKMountable>> *CKMountLayout(const RCLayout &layout,
+                                      UIView *view,
+                                      NSSet<id<CKMountable>> *previouslyMountedComponents,
+                                      id<CKMountable> supercomponent,
+                                      CK::Component::MountAnalyticsContext *mountAnalyticsContext,
+                                      id<CKMountLayoutListener> listener,
+                                      RCIncrementalMountState *incrementalMountState)
+{
+  RCResumableLayoutMount mount {
+    layout,
+    view,
+    previouslyMountedComponents,
+    supercomponent,
+    mountAnalyticsContext,
+    listener,
+    incrementalMountState,
+  };
+  mount.mountUntil(INFINITY);
+  return mount.mountedComponents();
 }
 
 void CKUnmountComponents(NSSet<id<CKMountable>> *componentsToUnmount)
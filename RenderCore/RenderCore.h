@@ -37,6 +37,7 @@
 #import <RenderCore/CKInternalHelpers.h>
 #import <RenderCore/RCIterable.h>
 #import <RenderCore/RCLayout.h>
+#import <RenderCore/RCPersistentMap.h>
 #import <RenderCore/CKMacros.h>
 #import <RenderCore/CKMountable.h>
 #import <RenderCore/CKMountableHelpers.h>
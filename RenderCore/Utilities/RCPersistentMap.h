@@ -0,0 +1,282 @@
+/*
+ *  Copyright (c) 2014-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#import <RenderCore/CKDefines.h>
+
+#if CK_NOT_SWIFT
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace RC {
+
+  /**
+   An immutable hash map with structural sharing (a hash array mapped trie).
+
+   Copying a map is O(1), and `insert`/`erase` return a new map in O(log32 n) that shares all untouched nodes with the
+   original. Maps can be read from several threads concurrently; the nodes are never mutated once they are shared, and
+   they are freed as soon as no map version references them anymore.
+
+   A map that is being filled by a single owner can use `insertInPlace` instead, which only copies the nodes it shares
+   with other map versions.
+
+   Keys are looked up by hash first; the hash is mixed internally, so a plain pointer hash is fine.
+   */
+  template <typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+  class PersistentMap {
+  public:
+    PersistentMap() noexcept : _size(0) {}
+
+    size_t size() const noexcept { return _size; }
+    bool empty() const noexcept { return _size == 0; }
+
+    /** Returns a pointer to the value for `key`, or nullptr. The pointer is valid as long as this map is alive. */
+    const Value *find(const Key &key) const
+    {
+      const size_t hash = mixedHash(key);
+      const Node *node = _root.get();
+      for (unsigned shift = 0; node != nullptr; shift += kBitsPerLevel) {
+        const uint32_t bit = bitAt(hash, shift);
+        if ((node->bitmap & bit) == 0) {
+          return nullptr;
+        }
+        const Slot &slot = node->slots[indexOf(node->bitmap, bit)];
+        if (slot.child) {
+          node = slot.child.get();
+          continue;
+        }
+        if (slot.hash != hash) {
+          return nullptr;
+        }
+        for (const auto &entry : *slot.entries) {
+          if (KeyEqual()(entry.first, key)) {
+            return &entry.second;
+          }
+        }
+        return nullptr;
+      }
+      return nullptr;
+    }
+
+    bool contains(const Key &key) const { return find(key) != nullptr; }
+
+    /** Returns a new map where `key` maps to `value`, replacing any previous value. */
+    PersistentMap insert(const Key &key, Value value) const
+    {
+      bool added = false;
+      PersistentMap result;
+      result._root = insertInNode(_root, 0, mixedHash(key), key, std::move(value), added, false);
+      result._size = _size + (added ? 1 : 0);
+      return result;
+    }
+
+    /**
+     Makes `key` map to `value` in this map, replacing any previous value. The nodes that no other map version references
+     are updated in place, so filling a new map this way does not path-copy anything. Must not be called while the map is
+     read from another thread.
+     */
+    void insertInPlace(const Key &key, Value value)
+    {
+      bool added = false;
+      _root = insertInNode(std::move(_root), 0, mixedHash(key), key, std::move(value), added, true);
+      _size += added ? 1 : 0;
+    }
+
+    /** Returns a new map without `key`. Returns a copy of this map if `key` is not present. */
+    PersistentMap erase(const Key &key) const
+    {
+      if (!contains(key)) {
+        return *this;
+      }
+      PersistentMap result;
+      result._root = eraseFromNode(_root.get(), 0, mixedHash(key), key);
+      result._size = _size - 1;
+      return result;
+    }
+
+    /** Calls `f(key, value)` for every entry, in unspecified order. */
+    template <typename F>
+    void forEach(F &&f) const
+    {
+      forEachInNode(_root.get(), f);
+    }
+
+  private:
+    static constexpr unsigned kBitsPerLevel = 5;
+
+    struct Node;
+    using Entries = std::vector<std::pair<Key, Value>>;
+
+    /** Either a child node, or a leaf holding all the entries whose full hash is `hash`. */
+    struct Slot {
+      std::shared_ptr<const Node> child;
+      std::shared_ptr<const Entries> entries;
+      size_t hash;
+    };
+
+    struct Node {
+      uint32_t bitmap = 0;
+      std::vector<Slot> slots;
+    };
+
+    static size_t mixedHash(const Key &key)
+    {
+      // Finalizer of MurmurHash3; spreads pointer-like hashes, whose low bits are always zero, over all the bits.
+      uint64_t h = Hash()(key);
+      h ^= h >> 33;
+      h *= 0xff51afd7ed558ccdULL;
+      h ^= h >> 33;
+      h *= 0xc4ceb9fe1a85ec53ULL;
+      h ^= h >> 33;
+      return (size_t)h;
+    }
+
+    static uint32_t bitAt(size_t hash, unsigned shift)
+    {
+      return 1u << ((hash >> shift) & 0x1f);
+    }
+
+    static size_t indexOf(uint32_t bitmap, uint32_t bit)
+    {
+      return __builtin_popcount(bitmap & (bit - 1));
+    }
+
+    static Slot leaf(size_t hash, const Key &key, Value value)
+    {
+      auto entries = std::make_shared<Entries>();
+      entries->emplace_back(key, std::move(value));
+      return {nullptr, std::move(entries), hash};
+    }
+
+    /** Builds the node holding two leaves with different hashes, which collide on all levels above `shift`. */
+    static std::shared_ptr<const Node> mergeLeaves(Slot a, Slot b, unsigned shift)
+    {
+      auto node = std::make_shared<Node>();
+      const uint32_t bitA = bitAt(a.hash, shift);
+      const uint32_t bitB = bitAt(b.hash, shift);
+      if (bitA == bitB) {
+        node->bitmap = bitA;
+        node->slots.push_back({mergeLeaves(std::move(a), std::move(b), shift + kBitsPerLevel), nullptr, 0});
+      } else {
+        node->bitmap = bitA | bitB;
+        if (bitA < bitB) {
+          node->slots.push_back(std::move(a));
+          node->slots.push_back(std::move(b));
+        } else {
+          node->slots.push_back(std::move(b));
+          node->slots.push_back(std::move(a));
+        }
+      }
+      return node;
+    }
+
+    template <typename T>
+    static std::shared_ptr<T> ownedOrCopied(std::shared_ptr<const T> p, bool inPlace)
+    {
+      if (inPlace && p.use_count() == 1) {
+        return std::const_pointer_cast<T>(std::move(p));
+      }
+      return std::make_shared<T>(*p);
+    }
+
+    static std::shared_ptr<const Node> insertInNode(std::shared_ptr<const Node> node, unsigned shift, size_t hash, const Key &key, Value value, bool &added, bool inPlace)
+    {
+      auto newNode = node ? ownedOrCopied(std::move(node), inPlace) : std::make_shared<Node>();
+      const uint32_t bit = bitAt(hash, shift);
+      const size_t index = indexOf(newNode->bitmap, bit);
+      if ((newNode->bitmap & bit) == 0) {
+        newNode->bitmap |= bit;
+        newNode->slots.insert(newNode->slots.begin() + index, leaf(hash, key, std::move(value)));
+        added = true;
+        return newNode;
+      }
+
+      Slot &slot = newNode->slots[index];
+      if (slot.child) {
+        slot.child = insertInNode(std::move(slot.child), shift + kBitsPerLevel, hash, key, std::move(value), added, inPlace);
+      } else if (slot.hash == hash) {
+        auto entries = ownedOrCopied(std::move(slot.entries), inPlace);
+        auto it = entries->begin();
+        for (; it != entries->end(); ++it) {
+          if (KeyEqual()(it->first, key)) {
+            break;
+          }
+        }
+        if (it != entries->end()) {
+          it->second = std::move(value);
+        } else {
+          entries->emplace_back(key, std::move(value));
+          added = true;
+        }
+        slot.entries = std::move(entries);
+      } else {
+        slot = {mergeLeaves(slot, leaf(hash, key, std::move(value)), shift + kBitsPerLevel), nullptr, 0};
+        added = true;
+      }
+      return newNode;
+    }
+
+    /** Returns nullptr when the resulting node would be empty. */
+    static std::shared_ptr<const Node> eraseFromNode(const Node *node, unsigned shift, size_t hash, const Key &key)
+    {
+      auto newNode = std::make_shared<Node>(*node);
+      const uint32_t bit = bitAt(hash, shift);
+      const size_t index = indexOf(newNode->bitmap, bit);
+      Slot &slot = newNode->slots[index];
+      bool removeSlot = false;
+      if (slot.child) {
+        slot.child = eraseFromNode(slot.child.get(), shift + kBitsPerLevel, hash, key);
+        removeSlot = slot.child == nullptr;
+      } else {
+        auto entries = std::make_shared<Entries>();
+        for (const auto &entry : *slot.entries) {
+          if (!KeyEqual()(entry.first, key)) {
+            entries->push_back(entry);
+          }
+        }
+        removeSlot = entries->empty();
+        slot.entries = std::move(entries);
+      }
+      if (removeSlot) {
+        newNode->bitmap &= ~bit;
+        newNode->slots.erase(newNode->slots.begin() + index);
+      }
+      return newNode->slots.empty() ? nullptr : newNode;
+    }
+
+    template <typename F>
+    static void forEachInNode(const Node *node, F &f)
+    {
+      if (node == nullptr) {
+        return;
+      }
+      for (const auto &slot : node->slots) {
+        if (slot.child) {
+          forEachInNode(slot.child.get(), f);
+        } else {
+          for (const auto &entry : *slot.entries) {
+            f(entry.first, entry.second);
+          }
+        }
+      }
+    }
+
+    std::shared_ptr<const Node> _root;
+    size_t _size;
+  };
+
+}
+
+#endif
@@ -165,8 +165,8 @@ namespace CK {
      */
     class ViewManager {
     public:
-      ViewManager(UIView *v, MountAnalyticsContext *ma = nullptr) : view(v), viewReusePoolMap(ViewReusePoolMap::viewReusePoolMapForView(v)), mountAnalyticsContext(ma) {};
-      ~ViewManager() { viewReusePoolMap.reset(view, mountAnalyticsContext); }
+      ViewManager(UIView *v, MountAnalyticsContext *ma = nullptr) : view(v), viewReusePoolMap(ViewReusePoolMap::viewReusePoolMapForView(v)), mountAnalyticsContext(ma), keepsPreviousMount(false) {};
+      ~ViewManager() { if (!keepsPreviousMount) { viewReusePoolMap.reset(view, mountAnalyticsContext); } }
 
       /** The view being managed. */
       UIView *const view;
@@ -178,9 +178,20 @@ namespace CK {
         return viewReusePoolMap.viewForConfiguration(componentClass, config, view, mountAnalyticsContext);
       }
 
+      /**
+       Leaves the subviews of the managed view exactly as the previous mount pass left them, instead of hiding the ones
+       that were not vended during this pass. Used when the children of a view are not mounted again because they did
+       not change; no view should be vended from this manager in that case.
+       */
+      void keepPreviousMount() noexcept
+      {
+        keepsPreviousMount = true;
+      }
+
     private:
       ViewReusePoolMap &viewReusePoolMap;
       MountAnalyticsContext *mountAnalyticsContext;
+      bool keepsPreviousMount;
 
       ViewManager(const ViewManager&) = delete;
       ViewManager &operator=(const ViewManager&) = delete;
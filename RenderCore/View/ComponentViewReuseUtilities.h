@@ -26,6 +26,7 @@ namespace CK {
       NSUInteger viewReuses = 0;
       NSUInteger viewHides = 0;
       NSUInteger viewUnhides = 0;
+      NSUInteger skippedComponentMounts = 0;
     };
 
     class ViewReuseUtilities {
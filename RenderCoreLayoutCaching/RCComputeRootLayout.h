@@ -4,11 +4,41 @@
 
 #if CK_NOT_SWIFT
 
+#import <memory>
+#import <vector>
+
 #import <RenderCore/RCLayout.h>
 
 @protocol CKMountable;
 struct RCLayoutCache;
 
+/** How a layout cache stores its entries. A cache keeps its backend across layout passes. */
+typedef NS_ENUM(NSInteger, RCLayoutCacheBackend) {
+  /**
+   One persistent map per generation, which starts as an O(1) copy of the previous generation and is filled in place.
+   Hits don't copy anything. At the end of each pass, only the entries of the mountables in its layout are kept, so the
+   entries of a removed subtree are not retained past the pass that removed it.
+   */
+  RCLayoutCacheBackendPersistentMap = 0,
+  /**
+   One flat open-addressing table per generation, keyed by (mountable, size range, parent size). Lookups don't allocate
+   and cost a single probe sequence, but the entries of a hit subtree are copied over to the next generation.
+   */
+  RCLayoutCacheBackendFlatTable,
+};
+
+struct RCLayoutCacheStatistics {
+  /** Lookups that matched the size range and parent size of a cached layout exactly. */
+  NSUInteger exactHits;
+  /**
+   Lookups served by a cached layout whose size fits in the requested size range, for components that declare
+   +[CKMountable hasMonotonicSizing].
+   */
+  NSUInteger subsumedHits;
+  /** Lookups that had to compute a layout. */
+  NSUInteger misses;
+};
+
 struct RCLayoutResult {
   /** The computed layout */
   RCLayout layout;
@@ -18,14 +48,19 @@ struct RCLayoutResult {
 
 /**
  Internal-only helper function that searches for a cached RCLayout
- in the thread-local *read* layout cache.
+ in the thread-local layout caches of the current and previous generations.
 
- If it finds a matching layout in the *read* layout cache, it copies that
- layout (and all cached layouts for its descendants) to the *write*
- layout cache and returns the layout.
+ If it finds a matching layout in the previous generation, it keeps that
+ layout (and all cached layouts for its descendants) in the current
+ generation and returns the layout.
+
+ If the mountable declares +[CKMountable hasMonotonicSizing], a cached layout
+ whose size fits in `sizeRange` is reused as well, and stored under the new key.
+ Such layouts are only reused under the same `parentSize` if the size of the
+ mountable is relative to its parent size.
 
  If it does not find a matching layout, it invokes the layoutFunction to
- compute a layout, stores it in the *write* layout cache, and returns it.
+ compute a layout, stores it in the current generation, and returns it.
 
  This is intended to be used as a helper when implementing the
  -layoutThatFits:parentSize: method. It should not be used externally.
@@ -37,6 +72,50 @@ RCLayout RCFetchOrComputeLayout(
   RCLayout (*layoutFunction)(id<CKMountable> mountable, const CKSizeRange &sizeRange, CGSize parentSize)
 );
 
+/**
+ Lets layouts that are computed concurrently on other threads use the layout cache of the current thread.
+
+ Each concurrent layout gets a cache of its own, which looks cached layouts up like the cache of the current thread
+ does. The caches of the concurrent layouts are merged into the cache of the current thread when
+ this object is destroyed, so it must be destroyed on the thread that created it, once the concurrent layouts are done.
+
+ Does nothing when the current thread has no layout cache.
+ */
+class RCConcurrentLayoutCaches {
+public:
+  /** `count` is the number of concurrent layouts. */
+  explicit RCConcurrentLayoutCaches(size_t count);
+  ~RCConcurrentLayoutCaches();
+
+  RCConcurrentLayoutCaches(const RCConcurrentLayoutCaches &) = delete;
+  RCConcurrentLayoutCaches &operator=(const RCConcurrentLayoutCaches &) = delete;
+
+  /** Uses the cache of the concurrent layout at `index` on the current thread while in scope. */
+  class Scope {
+  public:
+    Scope(const RCConcurrentLayoutCaches &caches, size_t index);
+    ~Scope();
+
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+  private:
+    RCLayoutCache *_previousCache;
+    const RCLayoutCache *_previousReadCache;
+  };
+
+private:
+  RCLayoutCache *_cache;
+  const RCLayoutCache *_readCache;
+  std::vector<std::shared_ptr<RCLayoutCache>> _caches;
+};
+
+/** Creates an empty layout cache, to be passed to the first call to RCComputeRootLayout. */
+std::shared_ptr<RCLayoutCache> RCLayoutCacheCreate(RCLayoutCacheBackend backend);
+
+/** Returns the cache statistics of the layout pass that produced `cache`. */
+RCLayoutCacheStatistics RCLayoutCacheGetStatistics(const RCLayoutCache &cache);
+
 /** Intended for use in tests only. */
 BOOL RCLayoutCacheContainsEntryForMountable(
   const RCLayoutCache &cache,
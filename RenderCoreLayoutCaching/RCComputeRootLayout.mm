@@ -2,73 +2,199 @@
 
 #import "RCComputeRootLayout.h"
 
-#import <unordered_map>
+#import <vector>
 
 #import <RenderCore/CKInternalHelpers.h>
 #import <RenderCore/CKMountable.h>
 #import <RenderCore/CKSizeRange.h>
 #import <RenderCore/RCLayout.h>
+#import <RenderCore/RCPersistentMap.h>
 
-// Considers NaNs equal to each other (unlike CGSizeEqualToSize). This is important for the layout cache
-// keys as identical keys that contain NaNs will be otherwise treated as different.
-static bool sizesAreEqual(const CGSize &lhs, const CGSize &rhs)
-{
-  return CKFloatsEqual(lhs.width, rhs.width) && CKFloatsEqual(lhs.height, rhs.height);
-}
+#import "RCLayoutCacheTable.h"
 
-struct RCLayoutCacheKey {
-  CKSizeRange constrainingSize;
-  CGSize parentSize;
+/**
+ Each layout pass fills a new generation of the cache.
 
-  bool operator==(const RCLayoutCacheKey &other) const
-  {
-    return constrainingSize == other.constrainingSize && sizesAreEqual(parentSize, other.parentSize);
-  }
-};
+ With the persistent map backend, a generation is a persistent map from mountable to the layouts computed for it, one
+ per constraint. A generation starts as an O(1) copy of the previous one, which it shares all of its nodes and entries
+ with, and is filled in place, so hits don't copy anything. Once the layout pass is done, only the entries of the
+ mountables in its layout are kept, so that the entries of mountables that are not laid out anymore are dropped.
 
-namespace std {
-  template <>
-  struct hash<RCLayoutCacheKey> {
-    size_t operator()(const RCLayoutCacheKey &key) const noexcept
-    {
-      return key.constrainingSize.hash();
-    }
+ With the flat table backend, a generation is a new flat table. Cache hits are looked up in the generation of the
+ previous pass as well, and the entries of the hit subtree are copied over to the new generation, so that the entries
+ of mountables that are not laid out anymore are dropped with the previous generation.
+ */
+struct RCLayoutCache {
+  struct Entries {
+    const std::vector<std::pair<RCLayoutCacheKey, RCLayout>> layouts;
   };
-}
 
-/** A layout cache is really just an unordered_map, under the covers. */
-struct RCLayoutCache {
-  std::unordered_map<id<CKMountable>, std::unordered_map<RCLayoutCacheKey, RCLayout>, RC::hash<id>> map;
+  RCLayoutCacheBackend backend = RCLayoutCacheBackendPersistentMap;
+
+  RC::PersistentMap<id<CKMountable>, std::shared_ptr<const Entries>, RC::hash<id>> map;
+  /** The mountables whose entries this cache updated, when it is merged into another one. */
+  std::vector<id<CKMountable>> updatedMountables;
+  bool recordsUpdatedMountables = false;
+
+  RCLayoutCacheTable table;
+
+  /** Statistics of the layout pass that produced this generation. */
+  RCLayoutCacheStatistics statistics = {};
 };
 
+thread_local RCLayoutCache *currentLayoutCache;
+/** The generation of the previous layout pass, if any. */
 thread_local const RCLayoutCache *currentLayoutReadCache;
-thread_local RCLayoutCache *currentLayoutWriteCache;
+
+static constexpr size_t kMaxEntriesPerMountable = 4;
+
+static const RCLayout *findLayout(const RCLayoutCache &cache, id<CKMountable> mountable, const RCLayoutCacheKey &key)
+{
+  const auto entries = cache.map.find(mountable);
+  if (entries == nullptr) {
+    return nullptr;
+  }
+  for (const auto &entry : (*entries)->layouts) {
+    if (entry.first == key) {
+      return &entry.second;
+    }
+  }
+  return nullptr;
+}
+
+static const RCLayout *findFittingLayout(const RCLayoutCache &cache,
+                                         id<CKMountable> mountable,
+                                         const RCLayoutCacheKey &key,
+                                         bool anyParentSize)
+{
+  const auto entries = cache.map.find(mountable);
+  if (entries == nullptr) {
+    return nullptr;
+  }
+  for (const auto &entry : (*entries)->layouts) {
+    if ((anyParentSize || entry.first.hasSameParentSize(key)) && RCLayoutFitsInSizeRange(entry.second, key.constrainingSize)) {
+      return &entry.second;
+    }
+  }
+  return nullptr;
+}
+
+static void insertLayout(RCLayoutCache &cache, id<CKMountable> mountable, const RCLayoutCacheKey &key, const RCLayout &layout)
+{
+  const auto previousEntries = cache.map.find(mountable);
+  // The entries may be shared with other generations, so they are never updated in place.
+  auto layouts = previousEntries
+  ? (*previousEntries)->layouts
+  : std::vector<std::pair<RCLayoutCacheKey, RCLayout>> {};
+  // Entries are kept for as long as their mountable is laid out, so only keep the most recent ones for each mountable.
+  if (layouts.size() >= kMaxEntriesPerMountable) {
+    layouts.erase(layouts.begin());
+  }
+  layouts.emplace_back(key, layout);
+  cache.map.insertInPlace(mountable, std::make_shared<const RCLayoutCache::Entries>(RCLayoutCache::Entries {std::move(layouts)}));
+  if (cache.recordsUpdatedMountables) {
+    cache.updatedMountables.push_back(mountable);
+  }
+}
+
+/** See +[CKMountable hasMonotonicSizing]. Only checked after a miss on the exact key. */
+static bool canReuseFittingLayout(id<CKMountable> mountable)
+{
+  return [[mountable class] hasMonotonicSizing];
+}
+
+/** Layouts cached under another parent size can only be reused if the size of the component does not depend on it. */
+static bool canReuseLayoutOfAnyParentSize(id<CKMountable> mountable)
+{
+  return !mountable.sizeIsRelativeToParentSize;
+}
 
 /**
- Recursively copies layout cache entries for the layout and all of its
- children. This ensures that the layout cache has comprehensive coverage
- of all component layouts, even when we get a cache hit.
+ Recursively copies the layout cache entries of the layout and all of its children from the previous flat table to the
+ current one. This ensures that the table has comprehensive coverage of all component layouts, even on a cache hit.
  */
-static void copyFromReadCacheToWriteCache(const RCLayout &layout,
-                                          const RCLayoutCache *readCache,
-                                          RCLayoutCache *writeCache)
-{
-  const auto &matches = readCache->map.find(layout.component);
-  if (matches != readCache->map.end()) {
-    // Copy all entries in the readCache's map to the writeCache's map,
-    // skipping any that are already present.
-    writeCache->map[layout.component].insert(
-      matches->second.begin(),
-      matches->second.end()
-    );
-  }
+static void copyTableEntriesForLayout(const RCLayout &layout, const RCLayoutCacheTable &from, RCLayoutCacheTable &to)
+{
+  from.copyEntriesOfMountable(layout.component, to);
   if (layout.children) {
     for (const auto &child : *layout.children) {
-      copyFromReadCacheToWriteCache(child.layout, readCache, writeCache);
+      copyTableEntriesForLayout(child.layout, from, to);
     }
   }
 }
 
+static RCLayout fetchOrComputeLayoutInTable(id<CKMountable> mountable,
+                                            const RCLayoutCacheKey &key,
+                                            RCLayout (*layoutFunction)(id<CKMountable> mountable, const CKSizeRange &sizeRange, CGSize parentSize))
+{
+  auto &table = currentLayoutCache->table;
+  auto &statistics = currentLayoutCache->statistics;
+  const RCLayoutCacheTable *const readTable = currentLayoutReadCache ? &currentLayoutReadCache->table : nullptr;
+
+  if (const auto match = table.find(mountable, key)) {
+    statistics.exactHits++;
+    return *match;
+  }
+  if (readTable) {
+    if (const auto match = readTable->find(mountable, key)) {
+      statistics.exactHits++;
+      const RCLayout layout = *match;
+      copyTableEntriesForLayout(layout, *readTable, table);
+      return layout;
+    }
+  }
+  if (canReuseFittingLayout(mountable)) {
+    const bool anyParentSize = canReuseLayoutOfAnyParentSize(mountable);
+    if (const auto match = table.findFittingLayout(mountable, key, anyParentSize)) {
+      statistics.subsumedHits++;
+      const RCLayout layout = *match;
+      table.insert(mountable, key, layout);
+      return layout;
+    }
+    if (readTable) {
+      if (const auto match = readTable->findFittingLayout(mountable, key, anyParentSize)) {
+        statistics.subsumedHits++;
+        const RCLayout layout = *match;
+        copyTableEntriesForLayout(layout, *readTable, table);
+        table.insert(mountable, key, layout);
+        return layout;
+      }
+    }
+  }
+
+  statistics.misses++;
+  const RCLayout layout = layoutFunction(mountable, key.constrainingSize, key.parentSize);
+  table.insert(mountable, key, layout);
+  return layout;
+}
+
+static RCLayout fetchOrComputeLayoutInMap(id<CKMountable> mountable,
+                                          const RCLayoutCacheKey &key,
+                                          RCLayout (*layoutFunction)(id<CKMountable> mountable, const CKSizeRange &sizeRange, CGSize parentSize))
+{
+  auto &cache = *currentLayoutCache;
+  auto &statistics = cache.statistics;
+
+  // The map already holds the entries of the previous generations, so there is no read cache to look hits up in.
+  if (const auto match = findLayout(cache, mountable, key)) {
+    statistics.exactHits++;
+    return *match;
+  }
+  if (canReuseFittingLayout(mountable)) {
+    if (const auto match = findFittingLayout(cache, mountable, key, canReuseLayoutOfAnyParentSize(mountable))) {
+      statistics.subsumedHits++;
+      const RCLayout layout = *match;
+      insertLayout(cache, mountable, key, layout);
+      return layout;
+    }
+  }
+
+  statistics.misses++;
+  const RCLayout layout = layoutFunction(mountable, key.constrainingSize, key.parentSize);
+  insertLayout(cache, mountable, key, layout);
+  return layout;
+}
+
 RCLayout RCFetchOrComputeLayout(id<CKMountable> mountable,
                                 const CKSizeRange &sizeRange,
                                 CGSize parentSize,
@@ -76,62 +202,136 @@ RCLayout RCFetchOrComputeLayout(id<CKMountable> mountable,
 {
   const RCLayoutCacheKey key {sizeRange, parentSize};
 
-  if (currentLayoutWriteCache) {
-    const auto it = currentLayoutWriteCache->map.find(mountable);
-    if (it != currentLayoutWriteCache->map.end()) {
-      const auto match = it->second.find(key);
-      if (match != it->second.end()) {
-        return match->second;
+  if (currentLayoutCache == nullptr) {
+    return layoutFunction(mountable, sizeRange, parentSize);
+  }
+  if (currentLayoutCache->backend == RCLayoutCacheBackendFlatTable) {
+    return fetchOrComputeLayoutInTable(mountable, key, layoutFunction);
+  }
+  return fetchOrComputeLayoutInMap(mountable, key, layoutFunction);
+}
+
+/** Merges a generation filled by a concurrent layout into the generation of the thread that started it. */
+static void mergeCache(const RCLayoutCache &from, RCLayoutCache &to)
+{
+  to.statistics.exactHits += from.statistics.exactHits;
+  to.statistics.subsumedHits += from.statistics.subsumedHits;
+  to.statistics.misses += from.statistics.misses;
+
+  if (to.backend == RCLayoutCacheBackendFlatTable) {
+    from.table.copyEntries(to.table);
+    return;
+  }
+  // A concurrent layout starts from a copy of the map it is merged into, so only the entries it updated are merged.
+  for (const auto &mountable : from.updatedMountables) {
+    const auto entries = from.map.find(mountable);
+    for (const auto &entry : (*entries)->layouts) {
+      if (findLayout(to, mountable, entry.first) == nullptr) {
+        insertLayout(to, mountable, entry.first, entry.second);
       }
     }
   }
+}
 
-  if (currentLayoutReadCache) {
-    const auto it = currentLayoutReadCache->map.find(mountable);
-    if (it != currentLayoutReadCache->map.end()) {
-      const auto match = it->second.find(key);
-      if (match != it->second.end()) {
-        // Found a hit! Copy the cached layout for this node *and descendants*
-        // from the read cache to the write cache, if there is one.
-        if (currentLayoutWriteCache) {
-          copyFromReadCacheToWriteCache(
-            match->second,
-            currentLayoutReadCache,
-            currentLayoutWriteCache
-          );
-        }
-        return match->second;
-      }
+RCConcurrentLayoutCaches::RCConcurrentLayoutCaches(size_t count)
+: _cache(currentLayoutCache), _readCache(currentLayoutReadCache)
+{
+  if (_cache == nullptr) {
+    return;
+  }
+  _caches.reserve(count);
+  for (size_t i = 0; i < count; i++) {
+    const auto cache = RCLayoutCacheCreate(_cache->backend);
+    if (cache->backend == RCLayoutCacheBackendPersistentMap) {
+      cache->map = _cache->map;
+      cache->recordsUpdatedMountables = true;
     }
+    _caches.push_back(cache);
   }
-  const RCLayout layout = layoutFunction(mountable, sizeRange, parentSize);
-  if (currentLayoutWriteCache) {
-    currentLayoutWriteCache->map[mountable].emplace(std::make_pair(key, layout));
+}
+
+RCConcurrentLayoutCaches::~RCConcurrentLayoutCaches()
+{
+  for (const auto &cache : _caches) {
+    mergeCache(*cache, *_cache);
   }
-  return layout;
+}
+
+RCConcurrentLayoutCaches::Scope::Scope(const RCConcurrentLayoutCaches &caches, size_t index)
+: _previousCache(currentLayoutCache), _previousReadCache(currentLayoutReadCache)
+{
+  currentLayoutCache = caches._cache ? caches._caches[index].get() : nullptr;
+  currentLayoutReadCache = caches._readCache;
+}
+
+RCConcurrentLayoutCaches::Scope::~Scope()
+{
+  currentLayoutCache = _previousCache;
+  currentLayoutReadCache = _previousReadCache;
+}
+
+std::shared_ptr<RCLayoutCache> RCLayoutCacheCreate(RCLayoutCacheBackend backend)
+{
+  const auto cache = std::make_shared<RCLayoutCache>();
+  cache->backend = backend;
+  return cache;
+}
+
+/**
+ Keeps the entries of the mountables in the layout. The other layouts cached for these mountables are kept too, but not
+ the entries of their children: hits on a layout don't look its children up.
+ */
+static void keepEntriesOfLayout(const RCLayout &layout, const RCLayoutCache &from, RCLayoutCache &to)
+{
+  if (layout.component != nil && !to.map.contains(layout.component)) {
+    if (const auto entries = from.map.find(layout.component)) {
+      to.map.insertInPlace(layout.component, *entries);
+    }
+  }
+  if (layout.children) {
+    for (const auto &child : *layout.children) {
+      keepEntriesOfLayout(child.layout, from, to);
+    }
+  }
+}
+
+static std::shared_ptr<RCLayoutCache> nextGeneration(const std::shared_ptr<RCLayoutCache> &cache)
+{
+  if (cache == nullptr) {
+    return std::make_shared<RCLayoutCache>();
+  }
+  const auto writeCache = RCLayoutCacheCreate(cache->backend);
+  if (cache->backend == RCLayoutCacheBackendFlatTable) {
+    // We expect the new table to have about as many entries as the previous one.
+    writeCache->table = RCLayoutCacheTable {cache->table.size()};
+    return writeCache;
+  }
+  writeCache->map = cache->map;
+  return writeCache;
 }
 
 RCLayoutResult RCComputeRootLayout(id<CKMountable> model,
                                         const CKSizeRange &constrainingSize,
                                         std::shared_ptr<RCLayoutCache> cache)
 {
-
-  const auto writeCache = std::make_shared<RCLayoutCache>();
-  if (cache) {
-    // We expect the writeCache to have about as many elements as the readCache.
-    // Reserve the appropriate number of buckets now to avoid rehashing later.
-    writeCache->map.reserve(cache->map.size());
-  }
+  const auto writeCache = nextGeneration(cache);
+  // The next generation of a persistent map already holds the entries of the previous one.
+  const RCLayoutCache *const readCache = writeCache->backend == RCLayoutCacheBackendFlatTable ? cache.get() : nullptr;
 
   // We don't expect nested root layouts, so the thread-local caches should generally be null.
   // But if a nested root layout *does* happen, we restore the previous caches before returning.
+  RCLayoutCache *const previousCache = currentLayoutCache;
   const RCLayoutCache *const previousReadCache = currentLayoutReadCache;
-  RCLayoutCache *const previousWriteCache = currentLayoutWriteCache;
-  currentLayoutReadCache = cache.get();
-  currentLayoutWriteCache = writeCache.get();
+  currentLayoutCache = writeCache.get();
+  currentLayoutReadCache = readCache;
   RCLayout layout = [model layoutThatFits:constrainingSize parentSize:constrainingSize.max];
+  currentLayoutCache = previousCache;
   currentLayoutReadCache = previousReadCache;
-  currentLayoutWriteCache = previousWriteCache;
+  if (writeCache->backend == RCLayoutCacheBackendPersistentMap) {
+    RCLayoutCache laidOut;
+    keepEntriesOfLayout(layout, *writeCache, laidOut);
+    writeCache->map = std::move(laidOut.map);
+  }
 
   return {
     .layout = layout,
@@ -139,7 +339,14 @@ RCLayoutResult RCComputeRootLayout(id<CKMountable> model,
   };
 }
 
+RCLayoutCacheStatistics RCLayoutCacheGetStatistics(const RCLayoutCache &cache)
+{
+  return cache.statistics;
+}
+
 BOOL RCLayoutCacheContainsEntryForMountable(const RCLayoutCache &cache, id<CKMountable> mountable)
 {
-  return cache.map.find(mountable) != cache.map.end();
+  return cache.backend == RCLayoutCacheBackendFlatTable
+  ? cache.table.containsMountable(mountable)
+  : cache.map.contains(mountable);
 }
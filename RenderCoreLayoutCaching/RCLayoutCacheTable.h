@@ -0,0 +1,81 @@
+// (c) Facebook, Inc. and its affiliates. Confidential and proprietary.
+
+#import <RenderCore/CKDefines.h>
+
+#if CK_NOT_SWIFT
+
+#import <vector>
+
+#import <RenderCore/CKSizeRange.h>
+#import <RenderCore/RCLayout.h>
+
+@protocol CKMountable;
+
+struct RCLayoutCacheKey {
+  CKSizeRange constrainingSize;
+  CGSize parentSize;
+
+  bool operator==(const RCLayoutCacheKey &other) const;
+  /** Compares the parent sizes only, with the same tolerance as operator==. */
+  bool hasSameParentSize(const RCLayoutCacheKey &other) const;
+  /**
+   Parent sizes are compared with a tolerance, so they are rounded before being hashed. Two parent sizes that are equal
+   but round differently only cause a cache miss.
+   */
+  size_t hash() const;
+};
+
+/** Whether the size of `layout` is within `sizeRange`, with the same tolerance as the cache keys. */
+bool RCLayoutFitsInSizeRange(const RCLayout &layout, const CKSizeRange &sizeRange);
+
+/**
+ A flat open-addressing table of cached layouts, keyed by (mountable, constraining size, parent size).
+
+ Every entry is stored inline in the slot array together with its precomputed combined hash, so a lookup is a single
+ probe sequence where mismatching slots are rejected by comparing hashes, and inserting does not allocate unless the
+ table grows. The probe sequence starts from the mountable alone: all the entries of a mountable are found in one run of
+ slots, which is what lets the entries of a whole subtree be carried over to the next table on a cache hit.
+ */
+class RCLayoutCacheTable {
+public:
+  RCLayoutCacheTable() noexcept : _count(0) {}
+  /** Creates a table that can hold `expectedCount` entries without growing. */
+  explicit RCLayoutCacheTable(size_t expectedCount);
+
+  size_t size() const noexcept { return _count; }
+
+  /** Returns the layout cached for `mountable` and `key`, or nullptr. The pointer is invalidated by insertions. */
+  const RCLayout *find(id<CKMountable> mountable, const RCLayoutCacheKey &key) const;
+  /** Inserts the layout unless there already is one for `mountable` and `key`. */
+  void insert(id<CKMountable> mountable, const RCLayoutCacheKey &key, const RCLayout &layout);
+
+  /**
+   Returns a layout cached for `mountable` under any size range, whose size fits in the size range of `key`, or nullptr.
+   Unless `anyParentSize` is true, only layouts cached under the parent size of `key` are considered.
+   */
+  const RCLayout *findFittingLayout(id<CKMountable> mountable, const RCLayoutCacheKey &key, bool anyParentSize) const;
+
+  bool containsMountable(id<CKMountable> mountable) const;
+  /** Inserts all the entries of `mountable` in `table`, skipping the ones it already has. */
+  void copyEntriesOfMountable(id<CKMountable> mountable, RCLayoutCacheTable &table) const;
+  /** Inserts all the entries in `table`, skipping the ones it already has. */
+  void copyEntries(RCLayoutCacheTable &table) const;
+
+private:
+  struct Slot {
+    /** nil for empty slots. */
+    id<CKMountable> mountable;
+    size_t hash;
+    RCLayoutCacheKey key;
+    RCLayout layout;
+  };
+
+  size_t homeIndex(id<CKMountable> mountable) const noexcept;
+  void insert(id<CKMountable> mountable, const RCLayoutCacheKey &key, size_t hash, const RCLayout &layout);
+  void grow();
+
+  std::vector<Slot> _slots;
+  size_t _count;
+};
+
+#endif
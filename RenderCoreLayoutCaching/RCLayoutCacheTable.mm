@@ -0,0 +1,184 @@
+// (c) Facebook, Inc. and its affiliates. Confidential and proprietary.
+
+#import "RCLayoutCacheTable.h"
+
+#import <cmath>
+
+#import <RenderCore/CKInternalHelpers.h>
+#import <RenderCore/RCEqualityHelpers.h>
+
+static constexpr size_t kMinimumCapacity = 16;
+
+// Considers NaNs equal to each other (unlike CGSizeEqualToSize). This is important for the layout cache
+// keys as identical keys that contain NaNs will be otherwise treated as different.
+static bool sizesAreEqual(const CGSize &lhs, const CGSize &rhs)
+{
+  return CKFloatsEqual(lhs.width, rhs.width) && CKFloatsEqual(lhs.height, rhs.height);
+}
+
+static uint64_t roundedHash(CGFloat value)
+{
+  return isnan(value) ? UINT64_MAX : std::hash<CGFloat>()(round(value * 1000));
+}
+
+bool RCLayoutCacheKey::operator==(const RCLayoutCacheKey &other) const
+{
+  return constrainingSize == other.constrainingSize && sizesAreEqual(parentSize, other.parentSize);
+}
+
+bool RCLayoutCacheKey::hasSameParentSize(const RCLayoutCacheKey &other) const
+{
+  return sizesAreEqual(parentSize, other.parentSize);
+}
+
+size_t RCLayoutCacheKey::hash() const
+{
+  return RCHash64ToNative(RCHashCombine(constrainingSize.hash(),
+                                        RCHashCombine(roundedHash(parentSize.width), roundedHash(parentSize.height))));
+}
+
+bool RCLayoutFitsInSizeRange(const RCLayout &layout, const CKSizeRange &sizeRange)
+{
+  return CKIsGreaterThanOrEqualWithTolerance(layout.size.width, sizeRange.min.width)
+  && CKIsGreaterThanOrEqualWithTolerance(sizeRange.max.width, layout.size.width)
+  && CKIsGreaterThanOrEqualWithTolerance(layout.size.height, sizeRange.min.height)
+  && CKIsGreaterThanOrEqualWithTolerance(sizeRange.max.height, layout.size.height);
+}
+
+static uint64_t pointerHash(id<CKMountable> mountable)
+{
+  return RCHashCombine((uintptr_t)(__bridge void *)mountable, 0);
+}
+
+static size_t capacityForCount(size_t count)
+{
+  // Keeps the load factor under 3/4.
+  size_t capacity = kMinimumCapacity;
+  while (capacity * 3 < count * 4) {
+    capacity *= 2;
+  }
+  return capacity;
+}
+
+RCLayoutCacheTable::RCLayoutCacheTable(size_t expectedCount) : _count(0)
+{
+  if (expectedCount > 0) {
+    _slots.resize(capacityForCount(expectedCount));
+  }
+}
+
+size_t RCLayoutCacheTable::homeIndex(id<CKMountable> mountable) const noexcept
+{
+  return RCHash64ToNative(pointerHash(mountable)) & (_slots.size() - 1);
+}
+
+const RCLayout *RCLayoutCacheTable::find(id<CKMountable> mountable, const RCLayoutCacheKey &key) const
+{
+  if (_count == 0) {
+    return nullptr;
+  }
+  const size_t hash = RCHash64ToNative(RCHashCombine(pointerHash(mountable), key.hash()));
+  const size_t mask = _slots.size() - 1;
+  for (size_t i = homeIndex(mountable); _slots[i].mountable != nil; i = (i + 1) & mask) {
+    const auto &slot = _slots[i];
+    if (slot.hash == hash && slot.mountable == mountable && slot.key == key) {
+      return &slot.layout;
+    }
+  }
+  return nullptr;
+}
+
+void RCLayoutCacheTable::insert(id<CKMountable> mountable, const RCLayoutCacheKey &key, const RCLayout &layout)
+{
+  insert(mountable, key, RCHash64ToNative(RCHashCombine(pointerHash(mountable), key.hash())), layout);
+}
+
+void RCLayoutCacheTable::insert(id<CKMountable> mountable, const RCLayoutCacheKey &key, size_t hash, const RCLayout &layout)
+{
+  if (mountable == nil) {
+    return;
+  }
+  if (_slots.size() * 3 < (_count + 1) * 4) {
+    grow();
+  }
+  const size_t mask = _slots.size() - 1;
+  size_t i = homeIndex(mountable);
+  for (; _slots[i].mountable != nil; i = (i + 1) & mask) {
+    const auto &slot = _slots[i];
+    if (slot.hash == hash && slot.mountable == mountable && slot.key == key) {
+      return;
+    }
+  }
+  _slots[i] = {mountable, hash, key, layout};
+  _count++;
+}
+
+const RCLayout *RCLayoutCacheTable::findFittingLayout(id<CKMountable> mountable,
+                                                      const RCLayoutCacheKey &key,
+                                                      bool anyParentSize) const
+{
+  if (_count == 0) {
+    return nullptr;
+  }
+  const size_t mask = _slots.size() - 1;
+  for (size_t i = homeIndex(mountable); _slots[i].mountable != nil; i = (i + 1) & mask) {
+    const auto &slot = _slots[i];
+    if (slot.mountable == mountable
+        && (anyParentSize || slot.key.hasSameParentSize(key))
+        && RCLayoutFitsInSizeRange(slot.layout, key.constrainingSize)) {
+      return &slot.layout;
+    }
+  }
+  return nullptr;
+}
+
+bool RCLayoutCacheTable::containsMountable(id<CKMountable> mountable) const
+{
+  if (_count == 0) {
+    return false;
+  }
+  const size_t mask = _slots.size() - 1;
+  for (size_t i = homeIndex(mountable); _slots[i].mountable != nil; i = (i + 1) & mask) {
+    if (_slots[i].mountable == mountable) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void RCLayoutCacheTable::copyEntriesOfMountable(id<CKMountable> mountable, RCLayoutCacheTable &table) const
+{
+  if (_count == 0) {
+    return;
+  }
+  // There are no deletions, so every entry of `mountable` was placed in the first free slot after its home index and
+  // all of them are found before the first empty slot.
+  const size_t mask = _slots.size() - 1;
+  for (size_t i = homeIndex(mountable); _slots[i].mountable != nil; i = (i + 1) & mask) {
+    const auto &slot = _slots[i];
+    if (slot.mountable == mountable) {
+      table.insert(slot.mountable, slot.key, slot.hash, slot.layout);
+    }
+  }
+}
+
+void RCLayoutCacheTable::copyEntries(RCLayoutCacheTable &table) const
+{
+  for (const auto &slot : _slots) {
+    if (slot.mountable != nil) {
+      table.insert(slot.mountable, slot.key, slot.hash, slot.layout);
+    }
+  }
+}
+
+void RCLayoutCacheTable::grow()
+{
+  std::vector<Slot> oldSlots(_slots.empty() ? kMinimumCapacity : _slots.size() * 2);
+  std::swap(oldSlots, _slots);
+  _count = 0;
+  for (auto &slot : oldSlots) {
+    if (slot.mountable != nil) {
+      insert(slot.mountable, slot.key, slot.hash, slot.layout);
+    }
+  }
+}
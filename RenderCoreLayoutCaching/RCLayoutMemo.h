@@ -0,0 +1,55 @@
+// (c) Facebook, Inc. and its affiliates. Confidential and proprietary.
+
+#import <RenderCore/CKDefines.h>
+
+#if CK_NOT_SWIFT
+
+#import <RenderCore/CKSizeRange.h>
+#import <RenderCore/RCLayout.h>
+
+@protocol CKMountable;
+
+/**
+ A global memo table of layouts, keyed by content instead of component identity, so that a layout computed for one
+ component can be reused by any other structurally identical component, in any scope root and on any thread.
+
+ Entries are keyed by (component class, -[CKMountable layoutContentKey], size range, parent size). Content keys are
+ compared with -isEqual:, so components whose keys merely have the same hash never share a layout.
+ They only store the shape of the layout (classes, sizes, positions and extras), never the components themselves; on a
+ hit the shape is bound to the requesting component and its children, walking both in parallel. Layouts whose children
+ don't match the children of their component one to one are not memoized.
+
+ On a hit, only the requesting component is laid out: its descendants are bound to the memoized shape without calling
+ -layoutThatFits:parentSize: on them. Their will/did layout callbacks (systrace and layout validation) don't run, and
+ their layouts are not looked up in or added to the layout cache of the current layout pass.
+
+ The table is bounded by a byte budget and evicts the least recently used entries first. It is disabled while the budget
+ is 0, which is the default unless CKGlobalConfig.layoutMemoByteBudget is set.
+ */
+RCLayout RCFetchOrComputeMemoizedLayout(
+  id<CKMountable> mountable,
+  id<NSObject> contentKey,
+  const CKSizeRange &sizeRange,
+  CGSize parentSize,
+  RCLayout (*layoutFunction)(id<CKMountable> mountable, const CKSizeRange &sizeRange, CGSize parentSize)
+);
+
+struct RCLayoutMemoStatistics {
+  NSUInteger hits;
+  NSUInteger misses;
+  /** Computed layouts that were not memoized because their shape does not match their component's children. */
+  NSUInteger rejections;
+  NSUInteger evictions;
+  /** Approximate memory used by the entries currently in the table, including their extras and content keys. */
+  size_t byteCount;
+};
+
+/** Sets the byte budget of the memo table, evicting entries if needed. Pass 0 to disable memoization. */
+void RCLayoutMemoSetByteBudget(size_t byteBudget);
+
+RCLayoutMemoStatistics RCLayoutMemoGetStatistics();
+
+/** Removes all entries and resets the statistics. */
+void RCLayoutMemoClear();
+
+#endif
@@ -0,0 +1,281 @@
+// (c) Facebook, Inc. and its affiliates. Confidential and proprietary.
+
+#import "RCLayoutMemo.h"
+
+#import <atomic>
+#import <list>
+#import <malloc/malloc.h>
+#import <memory>
+#import <unordered_map>
+#import <vector>
+
+#import <RenderCore/CKGlobalConfig.h>
+#import <RenderCore/CKInternalHelpers.h>
+#import <RenderCore/CKMountable.h>
+#import <RenderCore/CKMutex.h>
+#import <RenderCore/RCEqualityHelpers.h>
+
+#import "RCLayoutCacheTable.h"
+
+namespace {
+  struct MemoKey {
+    Class componentClass;
+    id<NSObject> contentKey;
+    RCLayoutCacheKey layoutKey;
+
+    bool operator==(const MemoKey &other) const
+    {
+      return componentClass == other.componentClass && layoutKey == other.layoutKey && RCObjectIsEqual(contentKey, other.contentKey);
+    }
+  };
+
+  struct MemoKeyHash {
+    size_t operator()(const MemoKey &key) const noexcept
+    {
+      return RCHash64ToNative(RCHashCombine(RCHashCombine((uintptr_t)(__bridge void *)key.componentClass, [key.contentKey hash]),
+                                            key.layoutKey.hash()));
+    }
+  };
+
+  /** A layout node without its component. Shapes are stored in pre-order. */
+  struct ShapeNode {
+    Class componentClass;
+    CGSize size;
+    CGPoint position;
+    uint32_t childCount;
+    NSDictionary *extra;
+  };
+
+  using Shape = std::vector<ShapeNode>;
+
+  struct Entry {
+    MemoKey key;
+    std::shared_ptr<const Shape> shape;
+    size_t byteCount;
+  };
+
+  /**
+   Approximate memory retained by `object`: its own allocation and, for collections, the allocations of their elements.
+   Tagged pointers and constants are not allocated, so they count as 0.
+   */
+  size_t objectByteCount(id object, int depth = 0)
+  {
+    if (object == nil) {
+      return 0;
+    }
+    __block size_t byteCount = malloc_size((__bridge const void *)object);
+    // Don't follow deeply nested collections, the estimate only needs to be in the right ballpark.
+    if (depth >= 2) {
+      return byteCount;
+    }
+    if ([object isKindOfClass:[NSDictionary class]]) {
+      [(NSDictionary *)object enumerateKeysAndObjectsUsingBlock:^(id key, id value, BOOL *stop) {
+        byteCount += objectByteCount(key, depth + 1) + objectByteCount(value, depth + 1);
+      }];
+    } else if ([object isKindOfClass:[NSArray class]] || [object isKindOfClass:[NSSet class]]) {
+      for (id element in (id<NSFastEnumeration>)object) {
+        byteCount += objectByteCount(element, depth + 1);
+      }
+    }
+    return byteCount;
+  }
+
+  /** Approximate memory retained by an entry: the entry, its shape, the extras of the shape and the content key. */
+  size_t entryByteCount(const MemoKey &key, const Shape &shape)
+  {
+    size_t byteCount = sizeof(Entry) + sizeof(ShapeNode) * shape.size() + objectByteCount(key.contentKey);
+    for (const auto &node : shape) {
+      byteCount += objectByteCount(node.extra);
+    }
+    return byteCount;
+  }
+
+  /** Whether `layout` lays out exactly the children of its component, in order, all the way down. */
+  bool layoutMatchesComponentTree(const RCLayout &layout)
+  {
+    id<CKMountable> const component = layout.component;
+    const auto childCount = layout.children ? layout.children->size() : 0;
+    if (component == nil || [component numberOfChildren] != childCount) {
+      return false;
+    }
+    for (unsigned int i = 0; i < childCount; i++) {
+      const auto &child = (*layout.children)[i];
+      if (child.layout.component != (id<CKMountable>)[component childAtIndex:i] || !layoutMatchesComponentTree(child.layout)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void appendShape(const RCLayout &layout, CGPoint position, Shape &shape)
+  {
+    const auto childCount = layout.children ? (uint32_t)layout.children->size() : 0;
+    shape.push_back({[layout.component class], layout.size, position, childCount, layout.extra});
+    for (uint32_t i = 0; i < childCount; i++) {
+      const auto &child = (*layout.children)[i];
+      appendShape(child.layout, child.position, shape);
+    }
+  }
+
+  /** Binds the shape starting at `index` to `component` and its children. Returns false if they don't match. */
+  bool bindShape(const Shape &shape, size_t &index, id<CKMountable> component, RCLayout &layout)
+  {
+    const auto &node = shape[index++];
+    if (component == nil || [component class] != node.componentClass || [component numberOfChildren] != node.childCount) {
+      return false;
+    }
+    if (node.childCount == 0) {
+      layout = {component, node.size};
+      layout.extra = node.extra;
+      return true;
+    }
+    std::vector<RCLayoutChild> children;
+    children.reserve(node.childCount);
+    for (unsigned int i = 0; i < node.childCount; i++) {
+      const auto position = shape[index].position;
+      RCLayout childLayout;
+      if (!bindShape(shape, index, (id<CKMountable>)[component childAtIndex:i], childLayout)) {
+        return false;
+      }
+      children.push_back({position, std::move(childLayout)});
+    }
+    layout = {component, node.size, std::move(children), node.extra};
+    return true;
+  }
+
+  class LayoutMemo {
+  public:
+    LayoutMemo() : _byteBudget(CKReadGlobalConfig().layoutMemoByteBudget), _statistics({}) {}
+
+    bool isEnabled() const
+    {
+      return _byteBudget.load(std::memory_order_relaxed) > 0;
+    }
+
+    std::shared_ptr<const Shape> find(const MemoKey &key)
+    {
+      CK::MutexLocker l(_mutex);
+      const auto it = _entries.find(key);
+      if (it == _entries.end()) {
+        _statistics.misses++;
+        return nullptr;
+      }
+      _statistics.hits++;
+      _lru.splice(_lru.begin(), _lru, it->second);
+      return it->second->shape;
+    }
+
+    void insert(const MemoKey &key, std::shared_ptr<const Shape> shape)
+    {
+      const size_t byteCount = entryByteCount(key, *shape);
+      CK::MutexLocker l(_mutex);
+      if (byteCount > _byteBudget.load(std::memory_order_relaxed) || _entries.find(key) != _entries.end()) {
+        return;
+      }
+      _lru.push_front({key, std::move(shape), byteCount});
+      _entries.emplace(key, _lru.begin());
+      _statistics.byteCount += byteCount;
+      evictIfNeeded();
+    }
+
+    void recordRejection()
+    {
+      CK::MutexLocker l(_mutex);
+      _statistics.rejections++;
+    }
+
+    void setByteBudget(size_t byteBudget)
+    {
+      CK::MutexLocker l(_mutex);
+      _byteBudget.store(byteBudget, std::memory_order_relaxed);
+      evictIfNeeded();
+    }
+
+    RCLayoutMemoStatistics statistics()
+    {
+      CK::MutexLocker l(_mutex);
+      return _statistics;
+    }
+
+    void clear()
+    {
+      CK::MutexLocker l(_mutex);
+      _entries.clear();
+      _lru.clear();
+      _statistics = {};
+    }
+
+  private:
+    void evictIfNeeded()
+    {
+      while (_statistics.byteCount > _byteBudget.load(std::memory_order_relaxed) && !_lru.empty()) {
+        const auto &entry = _lru.back();
+        _statistics.byteCount -= entry.byteCount;
+        _statistics.evictions++;
+        _entries.erase(entry.key);
+        _lru.pop_back();
+      }
+    }
+
+    CK::Mutex _mutex;
+    /** Only written under the mutex, but read without it to check whether the table is enabled. */
+    std::atomic<size_t> _byteBudget;
+    /** Most recently used first. */
+    std::list<Entry> _lru;
+    std::unordered_map<MemoKey, std::list<Entry>::iterator, MemoKeyHash> _entries;
+    RCLayoutMemoStatistics _statistics;
+  };
+
+  LayoutMemo &sharedMemo()
+  {
+    static LayoutMemo *memo = new LayoutMemo();
+    return *memo;
+  }
+}
+
+RCLayout RCFetchOrComputeMemoizedLayout(id<CKMountable> mountable,
+                                        id<NSObject> contentKey,
+                                        const CKSizeRange &sizeRange,
+                                        CGSize parentSize,
+                                        RCLayout (*layoutFunction)(id<CKMountable> mountable, const CKSizeRange &sizeRange, CGSize parentSize))
+{
+  auto &memo = sharedMemo();
+  if (contentKey == nil || !memo.isEnabled()) {
+    return layoutFunction(mountable, sizeRange, parentSize);
+  }
+
+  const MemoKey key {[mountable class], contentKey, {sizeRange, parentSize}};
+  if (const auto shape = memo.find(key)) {
+    // Binding happens outside of the lock; shapes are immutable once in the table.
+    size_t index = 0;
+    RCLayout layout;
+    if (bindShape(*shape, index, mountable, layout)) {
+      return layout;
+    }
+  }
+
+  const RCLayout layout = layoutFunction(mountable, sizeRange, parentSize);
+  if (layout.component == mountable && layoutMatchesComponentTree(layout)) {
+    auto shape = std::make_shared<Shape>();
+    appendShape(layout, CGPointZero, *shape);
+    memo.insert(key, std::move(shape));
+  } else {
+    memo.recordRejection();
+  }
+  return layout;
+}
+
+void RCLayoutMemoSetByteBudget(size_t byteBudget)
+{
+  sharedMemo().setByteBudget(byteBudget);
+}
+
+RCLayoutMemoStatistics RCLayoutMemoGetStatistics()
+{
+  return sharedMemo().statistics();
+}
+
+void RCLayoutMemoClear()
+{
+  sharedMemo().clear();
+}